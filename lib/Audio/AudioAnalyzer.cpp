@@ -0,0 +1,250 @@
+#include "AudioAnalyzer.h"
+#include <math.h>
+#include <string.h>
+
+// Bin power of a full-scale sine after the Hann window and the FFT's 1/N:
+// amplitude 32767/4, so power ~2^26
+static const int32_t FULL_SCALE_Q8 = 26 * 256;
+
+// log2(v) in Q8: exponent from the leading bit, mantissa linear (<0.09 err)
+static int32_t log2Q8(uint64_t v)
+{
+    if (v == 0)
+        return 0;
+    int32_t msb = 63 - __builtin_clzll(v);
+    uint32_t frac = msb >= 8 ? (uint32_t)(v >> (msb - 8)) & 0xFF
+                             : (uint32_t)(v << (8 - msb)) & 0xFF;
+    return msb * 256 + (int32_t)frac;
+}
+
+void AudioAnalyzer::begin(uint32_t sampleRate)
+{
+    rate = sampleRate;
+    fft.begin(AUDIO_FFT_LOG2);
+    const uint16_t n = fft.size();
+
+    frame.assign(n, 0);
+    re.assign(n, 0);
+    im.assign(n, 0);
+    window.resize(n);
+    for (uint16_t i = 0; i < n; i++)
+        window[i] = (int16_t)lroundf((0.5f - 0.5f * cosf(6.2831853f * i / n)) * 32767.0f);
+
+    // Log-spaced band edges, at least one bin wide
+    float binHz = (float)rate / n;
+    float hi = fminf(AUDIO_BAND_HI_HZ, rate * 0.5f);
+    for (uint8_t b = 0; b <= AUDIO_BANDS; b++)
+    {
+        float f = AUDIO_BAND_LO_HZ * powf(hi / AUDIO_BAND_LO_HZ, (float)b / AUDIO_BANDS);
+        int32_t bin = lroundf(f / binHz);
+        if (b == 0 && bin < 1)
+            bin = 1;
+        if (b > 0 && bin <= bandEdge[b - 1])
+            bin = bandEdge[b - 1] + 1;
+        if (bin > n / 2)
+            bin = n / 2;
+        bandEdge[b] = (uint16_t)bin;
+    }
+    for (uint8_t b = 0; b < AUDIO_BANDS; b++)
+        bandNorm[b] = log2Q8(bandEdge[b + 1] - bandEdge[b]);
+    totalNorm = log2Q8(bandEdge[AUDIO_BANDS] - bandEdge[0]);
+
+    refractoryHops = (uint16_t)((AUDIO_ONSET_REFRACTORY_MS * rate + 1000UL * AUDIO_HOP - 1) /
+                                (1000UL * AUDIO_HOP));
+
+    float hopRate = hopRateHz();
+    lagMin = (uint16_t)floorf(60.0f * hopRate / AUDIO_TEMPO_MAX_BPM);
+    lagMax = (uint16_t)ceilf(60.0f * hopRate / AUDIO_TEMPO_MIN_BPM);
+    if (lagMin < 2)
+        lagMin = 2;
+    if (lagMax > AUDIO_TEMPO_HISTORY / 2)
+        lagMax = AUDIO_TEMPO_HISTORY / 2;
+
+    env.assign(AUDIO_TEMPO_HISTORY, 0);
+    centered.assign(AUDIO_TEMPO_HISTORY, 0);
+    acf.assign(lagMax + 2, 0);
+    envHead = 0;
+
+    peakQ8 = AUDIO_FLOOR_Q8 + AUDIO_RANGE_Q8;
+    memset(prevLevel, 0, sizeof(prevLevel));
+    fluxMean16 = 0;
+    hopCount = 0;
+    lastOnsetHop = 0;
+    candidateBpm = 0.0f;
+    weakEstimates = 0;
+    feat = AudioFeatures();
+}
+
+void AudioAnalyzer::analyseSpectrum(int32_t bandLog[AUDIO_BANDS], int32_t &totalLog)
+{
+    const uint16_t n = fft.size();
+
+    // Block floating point: shift quiet frames up so the FFT keeps their
+    // low bits, and take the shift back out in the log domain
+    int32_t peak = 0;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int32_t a = frame[i] < 0 ? -(int32_t)frame[i] : frame[i];
+        if (a > peak)
+            peak = a;
+    }
+    uint8_t shift = 0;
+    while (peak && (peak << (shift + 1)) <= 32767)
+        shift++;
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        int32_t s = (int32_t)frame[i] << shift;
+        if (s > 32767)
+            s = 32767;
+        re[i] = (int16_t)((s * window[i]) >> 15);
+        im[i] = 0;
+    }
+
+    fft.transform(re.data(), im.data());
+
+    const int32_t offset = FULL_SCALE_Q8 + shift * 2 * 256;
+    uint64_t total = 0;
+    for (uint8_t b = 0; b < AUDIO_BANDS; b++)
+    {
+        uint64_t sum = 0;
+        for (uint16_t k = bandEdge[b]; k < bandEdge[b + 1]; k++)
+            sum += (uint32_t)((int32_t)re[k] * re[k]) + (uint32_t)((int32_t)im[k] * im[k]);
+        total += sum;
+
+        int32_t l = sum ? log2Q8(sum) - bandNorm[b] - offset : AUDIO_FLOOR_Q8;
+        bandLog[b] = l < AUDIO_FLOOR_Q8 ? AUDIO_FLOOR_Q8 : l;
+    }
+
+    int32_t l = total ? log2Q8(total) - totalNorm - offset : AUDIO_FLOOR_Q8;
+    totalLog = l < AUDIO_FLOOR_Q8 ? AUDIO_FLOOR_Q8 : l;
+}
+
+uint8_t AudioAnalyzer::toLevel(int32_t logQ8) const
+{
+    int32_t v = (logQ8 - (peakQ8 - AUDIO_RANGE_Q8)) * 255 / AUDIO_RANGE_Q8;
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+bool AudioAnalyzer::process(const int16_t *hop, uint32_t nowMs)
+{
+    const uint16_t n = fft.size();
+    memmove(frame.data(), frame.data() + AUDIO_HOP, (n - AUDIO_HOP) * sizeof(int16_t));
+    memcpy(frame.data() + n - AUDIO_HOP, hop, AUDIO_HOP * sizeof(int16_t));
+    hopCount++;
+
+    int32_t bandLog[AUDIO_BANDS];
+    int32_t totalLog;
+    analyseSpectrum(bandLog, totalLog);
+
+    // Decaying peak sets the top of the level window (never below the floor)
+    int32_t loudest = bandLog[0];
+    for (uint8_t b = 1; b < AUDIO_BANDS; b++)
+        if (bandLog[b] > loudest)
+            loudest = bandLog[b];
+    peakQ8 -= AUDIO_PEAK_DECAY_Q8;
+    if (loudest > peakQ8)
+        peakQ8 = loudest;
+    if (peakQ8 < AUDIO_FLOOR_Q8 + AUDIO_RANGE_Q8)
+        peakQ8 = AUDIO_FLOOR_Q8 + AUDIO_RANGE_Q8;
+
+    // Spectral flux: summed level rises across bands
+    uint32_t flux = 0;
+    for (uint8_t b = 0; b < AUDIO_BANDS; b++)
+    {
+        uint8_t lvl = toLevel(bandLog[b]);
+        if (lvl > prevLevel[b])
+            flux += lvl - prevLevel[b];
+        prevLevel[b] = lvl;
+        feat.bands[b] = lvl;
+    }
+    feat.level = toLevel(totalLog);
+    feat.updatedMs = nowMs;
+
+    bool onset = false;
+    uint32_t threshold = (uint32_t)(fluxMean16 * 3 / 2) / 16 + AUDIO_ONSET_MIN_FLUX;
+    if (flux > threshold && hopCount - lastOnsetHop >= refractoryHops)
+    {
+        onset = true;
+        lastOnsetHop = hopCount;
+        feat.onsetCount++;
+        feat.lastOnsetMs = nowMs;
+        // 64 at the threshold, 255 at ~4x
+        uint32_t s = flux * 64 / threshold;
+        feat.onsetStrength = (uint8_t)(s > 255 ? 255 : s);
+    }
+    fluxMean16 += ((int32_t)flux * 16 - fluxMean16) >> 4;
+
+    env[envHead] = (uint16_t)flux;
+    envHead = (envHead + 1) % AUDIO_TEMPO_HISTORY;
+    if (hopCount >= AUDIO_TEMPO_HISTORY && hopCount % AUDIO_TEMPO_INTERVAL == 0)
+        updateTempo();
+
+    return onset;
+}
+
+void AudioAnalyzer::updateTempo()
+{
+    const uint16_t h = AUDIO_TEMPO_HISTORY;
+
+    // Oldest first, mean removed
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < h; i++)
+        sum += env[i];
+    int32_t mean = (int32_t)(sum / h);
+    for (uint16_t i = 0; i < h; i++)
+        centered[i] = (int16_t)(env[(envHead + i) % h] - mean);
+
+    // Biased autocorrelation: fewer overlapping terms at longer lags, which
+    // favours the beat over its multiples
+    int64_t ac0 = 0;
+    for (uint16_t i = 0; i < h; i++)
+        ac0 += (int32_t)centered[i] * centered[i];
+    for (uint16_t lag = lagMin - 1; lag <= lagMax + 1; lag++)
+    {
+        int64_t a = 0;
+        for (uint16_t i = lag; i < h; i++)
+            a += (int32_t)centered[i] * centered[i - lag];
+        acf[lag] = a;
+    }
+
+    uint16_t best = lagMin;
+    for (uint16_t lag = lagMin + 1; lag <= lagMax; lag++)
+        if (acf[lag] > acf[best])
+            best = lag;
+
+    uint32_t conf = (ac0 > 0 && acf[best] > 0) ? (uint32_t)(acf[best] * 255 / ac0) : 0;
+    if (conf < AUDIO_TEMPO_MIN_CONFIDENCE)
+    {
+        if (++weakEstimates >= AUDIO_TEMPO_LOST_AFTER)
+        {
+            feat.bpm = 0.0f;
+            feat.confidence = 0;
+            candidateBpm = 0.0f;
+        }
+        return;
+    }
+    weakEstimates = 0;
+    feat.confidence = (uint8_t)(conf > 255 ? 255 : conf);
+
+    // Parabolic peak interpolation for a sub-hop lag
+    float y0 = (float)acf[best - 1], y1 = (float)acf[best], y2 = (float)acf[best + 1];
+    float den = y0 - 2.0f * y1 + y2;
+    float d = den < 0.0f ? 0.5f * (y0 - y2) / den : 0.0f;
+    if (d > 0.5f)
+        d = 0.5f;
+    if (d < -0.5f)
+        d = -0.5f;
+    float bpm = 60.0f * hopRateHz() / (best + d);
+
+    // Follow small drifts smoothly; a jump needs two estimates that agree
+    if (feat.bpm > 0.0f && fabsf(bpm - feat.bpm) <= feat.bpm * 0.04f)
+        feat.bpm += (bpm - feat.bpm) * 0.25f;
+    else if (candidateBpm > 0.0f && fabsf(bpm - candidateBpm) <= candidateBpm * 0.04f)
+    {
+        feat.bpm = bpm;
+        candidateBpm = 0.0f;
+    }
+    else
+        candidateBpm = bpm;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "AudioFeatures.h"
+#include "FixedFFT.h"
+
+// Analysis frame and hop: a 512-point FFT every 256 samples
+// (32 ms window, new features every 16 ms at 16 kHz)
+#define AUDIO_SAMPLE_RATE 16000
+#define AUDIO_FFT_LOG2 9
+#define AUDIO_HOP 256
+
+// Band range in Hz; the top is clamped to Nyquist
+#define AUDIO_BAND_LO_HZ 60.0f
+#define AUDIO_BAND_HI_HZ 8000.0f
+
+// Levels are log2 of power in 1/256 octave steps (1 octave = 3 dB).
+// Band levels span AUDIO_RANGE_Q8 below a peak that decays by
+// AUDIO_PEAK_DECAY_Q8 per hop; anything under AUDIO_FLOOR_Q8 (relative to
+// a full-scale sine) is treated as silence.
+#define AUDIO_RANGE_Q8 (13 * 256)
+#define AUDIO_PEAK_DECAY_Q8 1
+#define AUDIO_FLOOR_Q8 (-20 * 256)
+
+// Onset: spectral flux above 1.5x its running mean plus a minimum,
+// at most once per refractory period
+#define AUDIO_ONSET_MIN_FLUX 24
+#define AUDIO_ONSET_REFRACTORY_MS 100
+
+// Tempo: autocorrelation of the flux envelope over the last
+// AUDIO_TEMPO_HISTORY hops (~4 s), re-estimated every AUDIO_TEMPO_INTERVAL
+// hops. Lock is dropped after AUDIO_TEMPO_LOST_AFTER weak estimates in a row.
+#define AUDIO_TEMPO_MIN_BPM 70.0f
+#define AUDIO_TEMPO_MAX_BPM 180.0f
+#define AUDIO_TEMPO_HISTORY 256
+#define AUDIO_TEMPO_INTERVAL 32
+#define AUDIO_TEMPO_MIN_CONFIDENCE 48
+#define AUDIO_TEMPO_LOST_AFTER 8
+
+// Mono PCM in, AudioFeatures out: windowed fixed-point FFT, log-spaced band
+// levels, spectral-flux onsets and an autocorrelation tempo tracker.
+// Platform independent; AudioInput runs it on the device and the host
+// benchmark feeds it WAV files.
+class AudioAnalyzer
+{
+public:
+    void begin(uint32_t sampleRate = AUDIO_SAMPLE_RATE);
+
+    // One hop of AUDIO_HOP samples whose last sample was captured at nowMs.
+    // Returns true if the hop contained an onset.
+    bool process(const int16_t *hop, uint32_t nowMs);
+
+    const AudioFeatures &features() const { return feat; }
+    uint32_t sampleRate() const { return rate; }
+    float hopRateHz() const { return (float)rate / AUDIO_HOP; }
+    uint32_t hops() const { return hopCount; }
+    uint16_t bandLowHz(uint8_t b) const { return (uint16_t)(bandEdge[b] * rate / fft.size()); }
+
+private:
+    FixedFFT fft;
+    uint32_t rate = AUDIO_SAMPLE_RATE;
+
+    std::vector<int16_t> frame;  // last N input samples
+    std::vector<int16_t> window; // Hann, Q15
+    std::vector<int16_t> re, im;
+
+    uint16_t bandEdge[AUDIO_BANDS + 1] = {}; // first bin of each band, then the end
+    int32_t bandNorm[AUDIO_BANDS] = {};      // log2(bins in band), Q8
+    int32_t totalNorm = 0;
+
+    int32_t peakQ8 = AUDIO_FLOOR_Q8 + AUDIO_RANGE_Q8;
+    uint8_t prevLevel[AUDIO_BANDS] = {};
+    int32_t fluxMean16 = 0; // running mean of flux, x16
+    uint32_t hopCount = 0;
+    uint32_t lastOnsetHop = 0;
+    uint16_t refractoryHops = 1;
+
+    std::vector<uint16_t> env; // flux per hop, ring of AUDIO_TEMPO_HISTORY
+    std::vector<int16_t> centered;
+    std::vector<int64_t> acf;
+    uint16_t envHead = 0;
+    uint16_t lagMin = 0, lagMax = 0;
+    float candidateBpm = 0.0f;
+    uint8_t weakEstimates = 0;
+
+    AudioFeatures feat;
+
+    void analyseSpectrum(int32_t bandLog[AUDIO_BANDS], int32_t &totalLog);
+    uint8_t toLevel(int32_t logQ8) const;
+    void updateTempo();
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+
+// Number of log-spaced spectrum bands published to effects
+#define AUDIO_BANDS 8
+
+// What the audio pipeline tells the effects, refreshed once per audio hop
+// (16 ms at the default rate). Copied into LightingParams every frame.
+struct AudioFeatures
+{
+    // Per-band level, bass first; 0..255 across the analyzer's dynamic range
+    // window below the recent peak, so it self-adjusts to mic gain and volume
+    uint8_t bands[AUDIO_BANDS] = {};
+    uint8_t level = 0; // overall loudness, same scale
+
+    // Increments on every detected onset (kick, snare, ...); compare against
+    // the value seen last frame to catch hits
+    uint32_t onsetCount = 0;
+    uint32_t lastOnsetMs = 0;
+    uint8_t onsetStrength = 0; // of the last onset, 0..255
+
+    // Tracked tempo; 0 when there is no lock (silence, no clear beat)
+    float bpm = 0.0f;
+    uint8_t confidence = 0; // 0..255
+
+    uint32_t updatedMs = 0;
+    bool active = false; // an audio source is running
+};
@@ -0,0 +1,63 @@
+#include "AudioInput.h"
+
+bool AudioInput::begin(AudioSource *src, uint32_t sampleRate)
+{
+    source = src;
+    if (!source->begin(sampleRate))
+    {
+        source = nullptr;
+        return false;
+    }
+    analyzer.begin(source->sampleRate());
+
+#if defined(ESP32)
+    xTaskCreatePinnedToCore(taskEntry, "audio", AUDIO_TASK_STACK, this,
+                            AUDIO_TASK_PRIORITY, &task, AUDIO_TASK_CORE);
+#endif
+    return true;
+}
+
+bool AudioInput::step()
+{
+    if (!source || source->read(hop, AUDIO_HOP) < AUDIO_HOP)
+        return false;
+
+    uint32_t t0 = micros();
+    analyzer.process(hop, millis());
+    uint32_t us = micros() - t0;
+
+    processUs = us;
+    if (us > maxUs)
+        maxUs = us;
+    hopCount = hopCount + 1;
+
+#if defined(ESP32)
+    portENTER_CRITICAL(&lock);
+#endif
+    published = analyzer.features();
+    published.active = true;
+#if defined(ESP32)
+    portEXIT_CRITICAL(&lock);
+#endif
+    return true;
+}
+
+void AudioInput::latest(AudioFeatures &out) const
+{
+#if defined(ESP32)
+    portENTER_CRITICAL(&lock);
+#endif
+    out = published;
+#if defined(ESP32)
+    portEXIT_CRITICAL(&lock);
+#endif
+}
+
+#if defined(ESP32)
+void AudioInput::taskEntry(void *arg)
+{
+    AudioInput *self = static_cast<AudioInput *>(arg);
+    for (;;)
+        self->step();
+}
+#endif
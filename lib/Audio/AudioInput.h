@@ -0,0 +1,50 @@
+#pragma once
+#include <Arduino.h>
+#include "AudioAnalyzer.h"
+#include "AudioSource.h"
+
+// Capture task placement: core 0 next to the LED show task but below its
+// priority, so a frame transmission never waits on an FFT. The task sleeps
+// in the I2S driver between hops.
+#define AUDIO_TASK_CORE 0
+#define AUDIO_TASK_PRIORITY 1
+#define AUDIO_TASK_STACK 4096
+
+// Runs an AudioSource through the AudioAnalyzer and publishes the features
+// for the render loop. On the ESP32 a background task does this; elsewhere
+// call step() directly.
+class AudioInput
+{
+public:
+    // Starts the source (and on the ESP32 the capture task); false if the
+    // source didn't come up, in which case features stay inactive
+    bool begin(AudioSource *src, uint32_t sampleRate = AUDIO_SAMPLE_RATE);
+
+    // Reads and analyses one hop; false at the end of the source
+    bool step();
+
+    // Latest features, safe to call from the render loop
+    void latest(AudioFeatures &out) const;
+
+    uint32_t hopsProcessed() const { return hopCount; }
+    uint32_t lastProcessUs() const { return processUs; }
+    uint32_t maxProcessUs() const { return maxUs; }
+    uint32_t hopBudgetUs() const { return (uint32_t)(1000000ULL * AUDIO_HOP / analyzer.sampleRate()); }
+
+private:
+    AudioSource *source = nullptr;
+    AudioAnalyzer analyzer;
+    int16_t hop[AUDIO_HOP];
+
+    AudioFeatures published;
+    volatile uint32_t hopCount = 0;
+    volatile uint32_t processUs = 0;
+    volatile uint32_t maxUs = 0;
+
+#if defined(ESP32)
+    mutable portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    TaskHandle_t task = nullptr;
+
+    static void taskEntry(void *arg);
+#endif
+};
@@ -0,0 +1,132 @@
+#include "AudioSource.h"
+#include <string.h>
+
+#if defined(ESP32)
+
+bool I2SAudioSource::begin(uint32_t sampleRate)
+{
+    rate = sampleRate;
+
+    i2s_config_t cfg = {};
+    cfg.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX);
+    cfg.sample_rate = sampleRate;
+    cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT;
+    cfg.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    cfg.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    cfg.intr_alloc_flags = 0;
+    cfg.dma_buf_count = AUDIO_DMA_BUFFERS;
+    cfg.dma_buf_len = AUDIO_DMA_BUFFER_LEN;
+    cfg.use_apll = false;
+
+    i2s_pin_config_t pins = {};
+    pins.bck_io_num = AUDIO_PIN_BCK;
+    pins.ws_io_num = AUDIO_PIN_WS;
+    pins.data_out_num = I2S_PIN_NO_CHANGE;
+    pins.data_in_num = AUDIO_PIN_DATA;
+
+    if (i2s_driver_install(I2S_NUM_0, &cfg, 0, nullptr) != ESP_OK)
+        return false;
+    if (i2s_set_pin(I2S_NUM_0, &pins) != ESP_OK)
+    {
+        i2s_driver_uninstall(I2S_NUM_0);
+        return false;
+    }
+    i2s_zero_dma_buffer(I2S_NUM_0);
+    return true;
+}
+
+size_t I2SAudioSource::read(int16_t *dst, size_t n)
+{
+    if (raw.size() < n)
+        raw.resize(n);
+
+    size_t got = 0;
+    i2s_read(I2S_NUM_0, raw.data(), n * sizeof(int32_t), &got, portMAX_DELAY);
+    got /= sizeof(int32_t);
+
+    for (size_t i = 0; i < got; i++)
+    {
+        int32_t s = raw[i] >> AUDIO_I2S_SHIFT;
+        dst[i] = (int16_t)(s > 32767 ? 32767 : (s < -32768 ? -32768 : s));
+    }
+    return got;
+}
+
+#else
+
+WavAudioSource::~WavAudioSource()
+{
+    if (file)
+        fclose(file);
+}
+
+static uint32_t readLe32(const uint8_t *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint16_t readLe16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+bool WavAudioSource::begin(uint32_t)
+{
+    file = fopen(path, "rb");
+    if (!file)
+        return false;
+
+    uint8_t hdr[12];
+    if (fread(hdr, 1, 12, file) != 12 || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4))
+        return false;
+
+    // Walk the chunks: "fmt " first, then sample data in "data"
+    bool haveFmt = false;
+    uint8_t chunk[8];
+    while (fread(chunk, 1, 8, file) == 8)
+    {
+        uint32_t size = readLe32(chunk + 4);
+        if (!memcmp(chunk, "fmt ", 4))
+        {
+            uint8_t fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, file) != 16)
+                return false;
+            uint16_t format = readLe16(fmt);
+            channels = readLe16(fmt + 2);
+            rate = readLe32(fmt + 4);
+            uint16_t bits = readLe16(fmt + 14);
+            // PCM, or WAVE_FORMAT_EXTENSIBLE wrapping PCM
+            if ((format != 1 && format != 0xFFFE) || bits != 16 || channels < 1 || channels > 2)
+                return false;
+            haveFmt = true;
+            fseek(file, size - 16 + (size & 1), SEEK_CUR);
+        }
+        else if (!memcmp(chunk, "data", 4))
+        {
+            remaining = size;
+            return haveFmt;
+        }
+        else
+            fseek(file, size + (size & 1), SEEK_CUR);
+    }
+    return false;
+}
+
+size_t WavAudioSource::read(int16_t *dst, size_t n)
+{
+    if (!file)
+        return 0;
+
+    size_t want = n * channels;
+    if (want * 2 > remaining)
+        want = remaining / 2;
+    if (raw.size() < want)
+        raw.resize(want);
+
+    size_t got = fread(raw.data(), 2, want, file);
+    remaining -= (uint32_t)got * 2;
+
+    // Little-endian host assumed (x86/ARM)
+    size_t frames = got / channels;
+    if (channels == 1)
+        memcpy(dst, raw.data(), frames * sizeof(int16_t));
+    else
+        for (size_t i = 0; i < frames; i++)
+            dst[i] = (int16_t)(((int32_t)raw[2 * i] + raw[2 * i + 1]) / 2);
+    return frames;
+}
+
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#if defined(ESP32)
+#include <driver/i2s.h>
+#else
+#include <stdio.h>
+#endif
+
+// I2S microphone / line ADC (INMP441, SPH0645, PCM1808 ...): ESP32 is the
+// clock master, the converter sends 24-bit samples in 32-bit slots.
+// GPIO 35 is input-only; 2 and 12 are strapping pins but only driven by the
+// ESP32 after boot, so the converter can't upset them.
+#define AUDIO_PIN_BCK 2
+#define AUDIO_PIN_WS 12
+#define AUDIO_PIN_DATA 35
+// 32-bit slot -> int16: drop the empty low byte plus some headroom
+// (lower for a quiet mic, higher for a hot line input)
+#define AUDIO_I2S_SHIFT 14
+#define AUDIO_DMA_BUFFERS 4
+#define AUDIO_DMA_BUFFER_LEN 256
+
+// A stream of mono 16-bit samples
+class AudioSource
+{
+public:
+    virtual ~AudioSource() {}
+    virtual bool begin(uint32_t sampleRate) = 0;
+    // Fills dst with up to n samples, blocking until they're available.
+    // Returns fewer than n only at the end of a finite source.
+    virtual size_t read(int16_t *dst, size_t n) = 0;
+    virtual uint32_t sampleRate() const = 0;
+};
+
+#if defined(ESP32)
+// DMA capture from I2S0; read() blocks on the driver's DMA queue, so the
+// calling task sleeps between buffers
+class I2SAudioSource : public AudioSource
+{
+public:
+    bool begin(uint32_t sampleRate) override;
+    size_t read(int16_t *dst, size_t n) override;
+    uint32_t sampleRate() const override { return rate; }
+
+private:
+    uint32_t rate = 0;
+    std::vector<int32_t> raw;
+};
+#else
+// 16-bit PCM WAV file (mono, or stereo downmixed), for the host benchmark
+class WavAudioSource : public AudioSource
+{
+public:
+    explicit WavAudioSource(const char *path) : path(path) {}
+    ~WavAudioSource() override;
+
+    // Opens and parses the header; the file's own rate wins over sampleRate
+    bool begin(uint32_t sampleRate) override;
+    size_t read(int16_t *dst, size_t n) override;
+    uint32_t sampleRate() const override { return rate; }
+
+private:
+    const char *path;
+    FILE *file = nullptr;
+    uint32_t rate = 0;
+    uint16_t channels = 1;
+    uint32_t remaining = 0; // bytes of sample data left
+    std::vector<int16_t> raw;
+};
+#endif
@@ -0,0 +1,70 @@
+#include "FixedFFT.h"
+#include <math.h>
+
+void FixedFFT::begin(uint8_t log2n)
+{
+    n = (uint16_t)(1u << log2n);
+
+    cosTab.resize(n / 2);
+    sinTab.resize(n / 2);
+    for (uint16_t k = 0; k < n / 2; k++)
+    {
+        float a = 6.2831853f * k / n;
+        cosTab[k] = (int16_t)lroundf(cosf(a) * 32767.0f);
+        sinTab[k] = (int16_t)lroundf(-sinf(a) * 32767.0f);
+    }
+
+    bitrev.resize(n);
+    for (uint16_t i = 0; i < n; i++)
+    {
+        uint16_t r = 0;
+        for (uint8_t b = 0; b < log2n; b++)
+            if (i & (1u << b))
+                r |= (uint16_t)(1u << (log2n - 1 - b));
+        bitrev[i] = r;
+    }
+}
+
+void FixedFFT::transform(int16_t *re, int16_t *im) const
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        uint16_t j = bitrev[i];
+        if (j > i)
+        {
+            int16_t t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    // Butterflies keep |x| <= 32767: a unit twiddle preserves magnitude and
+    // (a +- t) / 2 can't exceed the larger operand
+    for (uint16_t len = 2, step = n / 2; len <= n; len <<= 1, step >>= 1)
+    {
+        uint16_t half = len / 2;
+        for (uint16_t start = 0; start < n; start += len)
+        {
+            for (uint16_t k = 0; k < half; k++)
+            {
+                int32_t wr = cosTab[k * step];
+                int32_t wi = sinTab[k * step];
+                uint16_t a = start + k;
+                uint16_t b = a + half;
+
+                int32_t tr = (wr * re[b] - wi * im[b]) >> 15;
+                int32_t ti = (wr * im[b] + wi * re[b]) >> 15;
+                int32_t ar = re[a];
+                int32_t ai = im[a];
+
+                re[a] = (int16_t)((ar + tr) >> 1);
+                im[a] = (int16_t)((ai + ti) >> 1);
+                re[b] = (int16_t)((ar - tr) >> 1);
+                im[b] = (int16_t)((ai - ti) >> 1);
+            }
+        }
+    }
+}
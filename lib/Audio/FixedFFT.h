@@ -0,0 +1,26 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+// In-place radix-2 complex FFT on Q15 data.
+//
+// Every stage halves its output, so nothing can overflow as long as the
+// input magnitudes fit in Q15: the result is the DFT divided by N. Scale
+// quiet input up before transforming (AudioAnalyzer normalises each frame)
+// to keep the low bits.
+class FixedFFT
+{
+public:
+    // Tables for a 2^log2n point transform (built once, floats allowed)
+    void begin(uint8_t log2n);
+
+    uint16_t size() const { return n; }
+
+    void transform(int16_t *re, int16_t *im) const;
+
+private:
+    uint16_t n = 0;
+    std::vector<int16_t> cosTab; // n/2 entries
+    std::vector<int16_t> sinTab; // -sin: forward twiddles
+    std::vector<uint16_t> bitrev;
+};
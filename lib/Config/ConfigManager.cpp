@@ -1,11 +1,13 @@
 #include "ConfigManager.h"
-#include <Arduino.h>
+#include <stddef.h>
 
 ConfigManager::ConfigManager()
     : activeMode(ConfigMode::Default),
       energyBurstState(EnergyBurstState::Inactive),
       bootEffectID(0)
 {
+    defaultCfg = &configs[0];
+
     // Initialize default configs with sensible values
     // Default mode - uses struct defaults from EffectConfig.h
     // (speed=127 ~50%, intensity=0)
@@ -37,25 +39,163 @@ void ConfigManager::begin()
     prefs.begin("totem", false); // Read-write mode
 
     // Load only Default config from NVS (special configs are runtime-only)
+    for (uint8_t i = 0; i < CONFIG_MODE_COUNT; i++)
+        stored[i] = pack(configs[i]);
     loadConfig(ConfigMode::Default);
 
     // Load boot effect ID
     bootEffectID = prefs.getUChar("boot_fx", 0);
+    storedBootEffectID = bootEffectID;
+
+#if defined(ESP32)
+    xTaskCreatePinnedToCore(taskEntry, "config", CONFIG_TASK_STACK, this,
+                            CONFIG_TASK_PRIORITY, &task, CONFIG_TASK_CORE);
+#endif
 
     Serial.println("ConfigManager: Loaded from NVS");
 }
 
 void ConfigManager::save()
 {
-    // Save only Default config (special configs are runtime-only)
+    // Save only Default config (special configs are runtime-only) and the
+    // scene that is up. Other recalled scenes may carry knob changes made
+    // while they were up; those were never saved and stay out of NVS.
     saveConfig(ConfigMode::Default);
+    if (scenePos)
+        saveScene(scenePos - 1);
 
     // Save boot effect ID
-    prefs.putUChar("boot_fx", bootEffectID);
+#if defined(ESP32)
+    portENTER_CRITICAL(&lock);
+#endif
+    if (bootEffectID != storedBootEffectID)
+    {
+        storedBootEffectID = bootEffectID;
+        dirty |= DIRTY_BOOT_FX;
+    }
+    bool queued = dirty != 0;
+#if defined(ESP32)
+    portEXIT_CRITICAL(&lock);
+#endif
+
+    if (!queued)
+    {
+        Serial.println("ConfigManager: Unchanged, nothing to save");
+        return;
+    }
+
+#if defined(ESP32)
+    xTaskNotifyGive(task);
+#else
+    flush();
+#endif
+}
+
+void ConfigManager::flush()
+{
+    ConfigBlob blobs[CONFIG_MODE_COUNT];
+    SceneBlob sceneBlobs[SCENE_COUNT];
+    uint8_t bootFx;
+
+#if defined(ESP32)
+    portENTER_CRITICAL(&lock);
+#endif
+    uint32_t d = dirty;
+    dirty = 0;
+    memcpy(blobs, stored, sizeof(blobs));
+    memcpy(sceneBlobs, storedScenes, sizeof(sceneBlobs));
+    bootFx = storedBootEffectID;
+#if defined(ESP32)
+    portEXIT_CRITICAL(&lock);
+#endif
+
+    if (!d)
+        return;
+
+    char key[8];
+    for (uint8_t i = 0; i < CONFIG_MODE_COUNT; i++)
+    {
+        if (!(d & (1 << i)))
+            continue;
+        snprintf(key, sizeof(key), "%s_cfg", getKeyPrefix((ConfigMode)i));
+        prefs.putBytes(key, &blobs[i], sizeof(ConfigBlob));
+        writeCount = writeCount + 1;
+    }
+    for (uint8_t i = 0; i < SCENE_COUNT; i++)
+    {
+        if (!(d & (1UL << (DIRTY_SCENE0 + i))))
+            continue;
+        snprintf(key, sizeof(key), "sc%u", (unsigned)(i + 1));
+        prefs.putBytes(key, &sceneBlobs[i], sizeof(SceneBlob));
+        writeCount = writeCount + 1;
+    }
+    if (d & DIRTY_BOOT_FX)
+    {
+        prefs.putUChar("boot_fx", bootFx);
+        writeCount = writeCount + 1;
+    }
 
     Serial.println("ConfigManager: Saved to NVS");
 }
 
+#if defined(ESP32)
+void ConfigManager::taskEntry(void *arg)
+{
+    ConfigManager *self = static_cast<ConfigManager *>(arg);
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->flush();
+    }
+}
+#endif
+
+void ConfigManager::exportSnapshot(ConfigSnapshot &out)
+{
+    memset(&out, 0, sizeof(out));
+    out.defaultConfig = pack(configs[0]);
+    out.bootEffectID = bootEffectID;
+
+    char key[8];
+    for (uint8_t i = 0; i < SCENE_COUNT; i++)
+    {
+        SceneBlob &b = out.scenes[i];
+        bool present;
+        if (scenesLoaded & (1 << i))
+        {
+            present = !scenes[i].blank;
+            if (present)
+                b = packScene(scenes[i]);
+        }
+        else
+        {
+            snprintf(key, sizeof(key), "sc%u", (unsigned)(i + 1));
+            present = prefs.getBytes(key, &b, sizeof(b)) == sizeof(b);
+        }
+        if (present)
+            out.scenesPresent |= 1 << i;
+    }
+}
+
+void ConfigManager::importSnapshot(const ConfigSnapshot &in)
+{
+    prefs.begin("totem", false);
+
+    char key[8];
+    snprintf(key, sizeof(key), "%s_cfg", getKeyPrefix(ConfigMode::Default));
+    prefs.putBytes(key, &in.defaultConfig, sizeof(ConfigBlob));
+    prefs.putUChar("boot_fx", in.bootEffectID);
+
+    for (uint8_t i = 0; i < SCENE_COUNT; i++)
+    {
+        snprintf(key, sizeof(key), "sc%u", (unsigned)(i + 1));
+        if (in.scenesPresent & (1 << i))
+            prefs.putBytes(key, &in.scenes[i], sizeof(SceneBlob));
+        else
+            prefs.remove(key);
+    }
+}
+
 void ConfigManager::setMode(ConfigMode mode)
 {
     if (activeMode != mode)
@@ -67,12 +207,40 @@ void ConfigManager::setMode(ConfigMode mode)
 
 EffectConfig &ConfigManager::getActiveConfig()
 {
-    return configs[(uint8_t)activeMode];
+    return getConfig(activeMode);
 }
 
 EffectConfig &ConfigManager::getConfig(ConfigMode mode)
 {
-    return configs[(uint8_t)mode];
+    return mode == ConfigMode::Default ? *defaultCfg : configs[(uint8_t)mode];
+}
+
+const Scene *ConfigManager::recallScene(uint8_t position)
+{
+    if (position > SCENE_COUNT)
+        position = 0;
+    scenePos = position;
+    if (position == 0)
+    {
+        defaultCfg = &configs[0];
+        return nullptr;
+    }
+
+    uint8_t i = position - 1;
+    if (!(scenesLoaded & (1 << i)))
+        loadScene(i);
+    defaultCfg = &scenes[i].config;
+    return &scenes[i];
+}
+
+void ConfigManager::captureScene(uint8_t effectID, uint8_t brightness)
+{
+    if (scenePos == 0)
+        return;
+    Scene &s = scenes[scenePos - 1];
+    s.effectID = effectID;
+    s.brightness = brightness;
+    s.blank = false;
 }
 
 void ConfigManager::setBootEffectID(uint8_t id)
@@ -106,60 +274,186 @@ const char *ConfigManager::getKeyPrefix(ConfigMode mode)
     }
 }
 
+ConfigBlob ConfigManager::pack(const EffectConfig &cfg)
+{
+    ConfigBlob b;
+    b.version = CONFIG_BLOB_VERSION;
+    b.mainHue = cfg.mainHue;
+    b.mainSat = cfg.mainSat;
+    b.secondaryHue = cfg.secondaryHue;
+    b.secondarySat = cfg.secondarySat;
+    b.speed = cfg.speed;
+    b.intensity = cfg.intensity;
+    b.secondaryEnabled = cfg.secondaryEnabled ? 1 : 0;
+    b.crc = crc16((const uint8_t *)&b, offsetof(ConfigBlob, crc));
+    return b;
+}
+
+void ConfigManager::unpack(const ConfigBlob &b, EffectConfig &cfg)
+{
+    cfg.mainHue = b.mainHue;
+    cfg.mainSat = b.mainSat;
+    cfg.secondaryHue = b.secondaryHue;
+    cfg.secondarySat = b.secondarySat;
+    cfg.speed = b.speed;
+    cfg.intensity = b.intensity;
+    cfg.secondaryEnabled = b.secondaryEnabled != 0;
+}
+
+// CRC-16/CCITT-FALSE
+uint16_t ConfigManager::crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    while (len--)
+    {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (uint8_t b = 0; b < 8; b++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
 void ConfigManager::loadConfig(ConfigMode mode)
+{
+    EffectConfig &cfg = configs[(uint8_t)mode];
+    char key[8];
+    snprintf(key, sizeof(key), "%s_cfg", getKeyPrefix(mode));
+
+    ConfigBlob b;
+    bool valid = prefs.getBytes(key, &b, sizeof(b)) == sizeof(b) &&
+                 b.version == CONFIG_BLOB_VERSION &&
+                 b.crc == crc16((const uint8_t *)&b, offsetof(ConfigBlob, crc));
+
+    if (valid)
+    {
+        unpack(b, cfg);
+        stored[(uint8_t)mode] = b;
+    }
+    else
+    {
+        if (prefs.isKey(key))
+            Serial.printf("ConfigManager: '%s' is corrupt or outdated, ignored\n", key);
+        // stored keeps the defaults, so the next save writes the blob
+        if (!loadLegacy(mode))
+            return;
+    }
+    cfg.touch();
+}
+
+// Firmware before the blob format stored one key per field
+bool ConfigManager::loadLegacy(ConfigMode mode)
 {
     const char *prefix = getKeyPrefix(mode);
     EffectConfig &cfg = configs[(uint8_t)mode];
 
     char key[8];
 
-    sprintf(key, "%s_mh", prefix);
+    snprintf(key, sizeof(key), "%s_mh", prefix);
+    if (!prefs.isKey(key))
+        return false;
     cfg.mainHue = prefs.getUChar(key, cfg.mainHue);
 
-    sprintf(key, "%s_ms", prefix);
+    snprintf(key, sizeof(key), "%s_ms", prefix);
     cfg.mainSat = prefs.getUChar(key, cfg.mainSat);
 
-    sprintf(key, "%s_sh", prefix);
+    snprintf(key, sizeof(key), "%s_sh", prefix);
     cfg.secondaryHue = prefs.getUChar(key, cfg.secondaryHue);
 
-    sprintf(key, "%s_ss", prefix);
+    snprintf(key, sizeof(key), "%s_ss", prefix);
     cfg.secondarySat = prefs.getUChar(key, cfg.secondarySat);
 
-    sprintf(key, "%s_spd", prefix);
+    snprintf(key, sizeof(key), "%s_spd", prefix);
     cfg.speed = prefs.getUChar(key, cfg.speed);
 
-    sprintf(key, "%s_int", prefix);
+    snprintf(key, sizeof(key), "%s_int", prefix);
     cfg.intensity = prefs.getUChar(key, cfg.intensity);
 
-    sprintf(key, "%s_sec", prefix);
+    snprintf(key, sizeof(key), "%s_sec", prefix);
     cfg.secondaryEnabled = prefs.getBool(key, cfg.secondaryEnabled);
+
+    return true;
 }
 
-void ConfigManager::saveConfig(ConfigMode mode)
+SceneBlob ConfigManager::packScene(const Scene &scene)
 {
-    const char *prefix = getKeyPrefix(mode);
-    EffectConfig &cfg = configs[(uint8_t)mode];
+    SceneBlob b;
+    b.config = pack(scene.config);
+    b.effectID = scene.effectID;
+    b.brightness = scene.brightness;
+    memcpy(b.name, scene.name, SCENE_NAME_LEN);
+    b.crc = crc16((const uint8_t *)&b, offsetof(SceneBlob, crc));
+    return b;
+}
 
+// First recall: the stored scene, or a blank one starting from the live
+// Default config
+void ConfigManager::loadScene(uint8_t i)
+{
+    Scene &s = scenes[i];
     char key[8];
+    snprintf(key, sizeof(key), "sc%u", (unsigned)(i + 1));
 
-    sprintf(key, "%s_mh", prefix);
-    prefs.putUChar(key, cfg.mainHue);
-
-    sprintf(key, "%s_ms", prefix);
-    prefs.putUChar(key, cfg.mainSat);
-
-    sprintf(key, "%s_sh", prefix);
-    prefs.putUChar(key, cfg.secondaryHue);
+    SceneBlob b;
+    bool valid = prefs.getBytes(key, &b, sizeof(b)) == sizeof(b) &&
+                 b.config.version == CONFIG_BLOB_VERSION &&
+                 b.crc == crc16((const uint8_t *)&b, offsetof(SceneBlob, crc));
 
-    sprintf(key, "%s_ss", prefix);
-    prefs.putUChar(key, cfg.secondarySat);
+    if (valid)
+    {
+        unpack(b.config, s.config);
+        s.effectID = b.effectID;
+        s.brightness = b.brightness;
+        memcpy(s.name, b.name, SCENE_NAME_LEN);
+        s.name[SCENE_NAME_LEN - 1] = '\0';
+        s.blank = false;
+        storedScenes[i] = b;
+    }
+    else
+    {
+        if (prefs.isKey(key))
+            Serial.printf("ConfigManager: '%s' is corrupt or outdated, ignored\n", key);
+        s.config = configs[0];
+        snprintf(s.name, SCENE_NAME_LEN, "Scene %u", (unsigned)(i + 1));
+        memset(&storedScenes[i], 0, sizeof(SceneBlob));
+    }
+    s.config.touch();
+    scenesLoaded |= 1 << i;
+}
 
-    sprintf(key, "%s_spd", prefix);
-    prefs.putUChar(key, cfg.speed);
+// Only scenes that were recalled and captured can have changed
+void ConfigManager::saveScene(uint8_t i)
+{
+    if (!(scenesLoaded & (1 << i)) || scenes[i].blank)
+        return;
+    SceneBlob b = packScene(scenes[i]);
+
+#if defined(ESP32)
+    portENTER_CRITICAL(&lock);
+#endif
+    if (memcmp(&b, &storedScenes[i], sizeof(b)) != 0)
+    {
+        storedScenes[i] = b;
+        dirty |= 1UL << (DIRTY_SCENE0 + i);
+    }
+#if defined(ESP32)
+    portEXIT_CRITICAL(&lock);
+#endif
+}
 
-    sprintf(key, "%s_int", prefix);
-    prefs.putUChar(key, cfg.intensity);
+void ConfigManager::saveConfig(ConfigMode mode)
+{
+    uint8_t i = (uint8_t)mode;
+    ConfigBlob b = pack(configs[i]);
 
-    sprintf(key, "%s_sec", prefix);
-    prefs.putBool(key, cfg.secondaryEnabled);
+#if defined(ESP32)
+    portENTER_CRITICAL(&lock);
+#endif
+    if (memcmp(&b, &stored[i], sizeof(b)) != 0)
+    {
+        stored[i] = b;
+        dirty |= 1 << i;
+    }
+#if defined(ESP32)
+    portEXIT_CRITICAL(&lock);
+#endif
 }
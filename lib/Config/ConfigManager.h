@@ -1,14 +1,85 @@
 #pragma once
+#include <Arduino.h>
 #include "EffectConfig.h"
+#include "Scene.h"
 #include <Preferences.h>
 
+// Bump when ConfigBlob's layout changes; blobs of another version are
+// ignored (the mode keeps its defaults)
+#define CONFIG_BLOB_VERSION 1
+
+// NVS writer task: low priority on core 0, it only wakes for a save
+#define CONFIG_TASK_CORE 0
+#define CONFIG_TASK_PRIORITY 1
+#define CONFIG_TASK_STACK 3072
+
+#define CONFIG_MODE_COUNT 4
+
+// One mode's config as stored in NVS: a single key per mode
+struct __attribute__((packed)) ConfigBlob
+{
+    uint8_t version;
+    uint8_t mainHue;
+    uint8_t mainSat;
+    uint8_t secondaryHue;
+    uint8_t secondarySat;
+    uint8_t speed;
+    uint8_t intensity;
+    uint8_t secondaryEnabled;
+    uint16_t crc; // CRC-16/CCITT of the bytes above
+};
+
+// One scene as stored in NVS (key "sc<n>")
+struct __attribute__((packed)) SceneBlob
+{
+    ConfigBlob config;
+    uint8_t effectID;
+    uint8_t brightness;
+    char name[SCENE_NAME_LEN];
+    uint16_t crc; // CRC-16/CCITT of the bytes above
+};
+
+// Everything begin() and scene recall read from NVS, so a recording can
+// carry it and a replay start from the same state
+struct __attribute__((packed)) ConfigSnapshot
+{
+    ConfigBlob defaultConfig;
+    uint8_t bootEffectID;
+    uint16_t scenesPresent; // bit per scene
+    SceneBlob scenes[SCENE_COUNT];
+};
+
+// Owns the per-mode configs and their NVS storage.
+//
+// Each mode is one versioned, CRC-checked blob. save() only compares the
+// blobs with what's in flash (a RAM copy) and hands the changed ones to a
+// background task: unchanged values are never rewritten, a changed mode
+// is one key, and loop() doesn't wait for the NVS lock or commit.
+// It does not remove the stall itself: an NVS write or erase disables the
+// flash cache on both cores, so loop(), the show task and the sampler all
+// pause for it whichever task issues it. Fewer, smaller writes keep those
+// pauses short and rare.
+//
+// It also holds the preset bank: SCENE_COUNT scenes, each read from NVS the
+// first time it's recalled.
 class ConfigManager
 {
 public:
     ConfigManager();
 
-    void begin(); // Load from NVS
-    void save();  // Save all configs to NVS
+    void begin(); // Load from NVS, start the writer
+    void save();  // Queue changed configs and the recalled scene for NVS (returns immediately)
+
+    // Writes whatever save() queued; the writer task calls this, and it
+    // runs inline where there is no task
+    void flush();
+
+    uint32_t writes() const { return writeCount; }
+
+    // State as begin() would load it now: take it before handling any
+    // input. importSnapshot() puts one into NVS; call it before begin().
+    void exportSnapshot(ConfigSnapshot &out);
+    void importSnapshot(const ConfigSnapshot &in);
 
     // Mode switching
     void setMode(ConfigMode mode);
@@ -18,6 +89,15 @@ public:
     EffectConfig &getActiveConfig();
     EffectConfig &getConfig(ConfigMode mode);
 
+    // Preset bank. Position 0 is the live Default config, 1..SCENE_COUNT
+    // the scenes. Recall swaps the config Default mode uses (refresh
+    // P.activeConfig afterwards); returns the scene, or nullptr for 0.
+    const Scene *recallScene(uint8_t position);
+    uint8_t scenePosition() const { return scenePos; }
+    // Stores the look into the recalled scene (no-op at position 0); the
+    // config itself is already live in it
+    void captureScene(uint8_t effectID, uint8_t brightness);
+
     // Boot effect ID
     void setBootEffectID(uint8_t id);
     uint8_t getBootEffectID() const { return bootEffectID; }
@@ -28,15 +108,46 @@ public:
 
 private:
     EffectConfig configs[4]; // [0]=Default, [1]=Special1, [2]=Special2, [3]=Special3
+    EffectConfig *defaultCfg; // configs[0] or the recalled scene's config
     ConfigMode activeMode;
     EnergyBurstState energyBurstState;
     uint8_t bootEffectID;
 
     Preferences prefs;
 
+    // What flash holds, so save() can diff without reading it back
+    ConfigBlob stored[CONFIG_MODE_COUNT];
+    uint8_t storedBootEffectID = 0;
+
+    Scene scenes[SCENE_COUNT];
+    SceneBlob storedScenes[SCENE_COUNT];
+    uint16_t scenesLoaded = 0; // bit per scene
+    uint8_t scenePos = 0;
+
+    // Set by save(), cleared by flush(); bit per mode, the boot effect, and
+    // from DIRTY_SCENE0 on a bit per scene
+    static const uint32_t DIRTY_BOOT_FX = 1 << CONFIG_MODE_COUNT;
+    static const uint8_t DIRTY_SCENE0 = 8;
+    volatile uint32_t dirty = 0;
+    volatile uint32_t writeCount = 0;
+
     void loadConfig(ConfigMode mode);
+    bool loadLegacy(ConfigMode mode);
     void saveConfig(ConfigMode mode);
+    void loadScene(uint8_t i);
+    void saveScene(uint8_t i);
+    static SceneBlob packScene(const Scene &scene);
+
+    static ConfigBlob pack(const EffectConfig &cfg);
+    static void unpack(const ConfigBlob &blob, EffectConfig &cfg);
+    static uint16_t crc16(const uint8_t *data, size_t len);
 
     // NVS key helpers
     const char *getKeyPrefix(ConfigMode mode);
+
+#if defined(ESP32)
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    TaskHandle_t task = nullptr;
+    static void taskEntry(void *arg);
+#endif
 };
@@ -13,6 +13,10 @@ struct EffectConfig
     // Default intensity
     uint8_t intensity = 127;
     bool secondaryEnabled = true;
+
+    // Bumped on every change so effects know to re-derive their constants
+    uint32_t generation = 0;
+    void touch() { generation++; }
 };
 
 // System operation modes
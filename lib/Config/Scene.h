@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include "EffectConfig.h"
+
+// Scenes in the preset bank (recall positions 1..SCENE_COUNT; 0 is the
+// live Default config)
+#define SCENE_COUNT 8
+#define SCENE_NAME_LEN 12 // including the terminator
+
+// A prepared look for Default mode. Recalling one points Default mode at
+// its config, so edits made while it's up go into the scene.
+struct Scene
+{
+    EffectConfig config;
+    uint8_t effectID = 0;
+    uint8_t brightness = 150;
+    // Never captured: recall keeps the current effect and brightness
+    bool blank = true;
+    char name[SCENE_NAME_LEN] = {};
+};
@@ -1,13 +1,37 @@
 #include "Encoder.h"
 
+#if defined(ESP32)
+#include <soc/gpio_struct.h>
+#endif
+
 // Quadrature transition table (Gray code).
 // index = (prev<<2) | curr ; value = -1, 0, +1 per transition
-static const int8_t QTAB[16] = {
+// In DRAM so the ISR never waits on a flash cache miss.
+static const DRAM_ATTR int8_t QTAB[16] = {
     0, -1, +1, 0,
     +1, 0, 0, -1,
     -1, 0, 0, +1,
     0, +1, -1, 0};
 
+#if ENCODER_ISR_STATS && defined(ESP32)
+static inline uint32_t IRAM_ATTR cycleCount()
+{
+    uint32_t c;
+    asm volatile("rsr %0, ccount" : "=a"(c));
+    return c;
+}
+#elif ENCODER_ISR_STATS
+static inline uint32_t cycleCount() { return 0; }
+#endif
+
+#if defined(ESP32)
+// GPIO 0..31 are in GPIO.in, 32..39 in GPIO.in1
+static const volatile uint32_t *inputReg(uint8_t pin)
+{
+    return pin < 32 ? &GPIO.in : &GPIO.in1.val;
+}
+#endif
+
 void Encoder::begin()
 {
     if (usePullups)
@@ -23,18 +47,32 @@ void Encoder::begin()
         pinMode(SW, INPUT);
     }
 
+#if defined(ESP32)
+    regA = inputReg(A);
+    regB = inputReg(B);
+    regSW = inputReg(SW);
+    maskA = 1u << (A & 31);
+    maskB = 1u << (B & 31);
+    maskSW = 1u << (SW & 31);
+#endif
+
     // Initialize quadrature previous state
     prev = (digitalRead(A) << 1) | digitalRead(B);
 
     // Initialize button states
     swRaw = digitalRead(SW); // HIGH = released (pull-up)
+    swEdge = false;
     swStable = swRaw;
     swStableSince = millis();
     swLastEdgeMs = 0;
 
-    // Attach interrupts with instance pointer
-    attachInterruptArg(digitalPinToInterrupt(A), isrAB_trampoline, this, CHANGE);
-    attachInterruptArg(digitalPinToInterrupt(B), isrAB_trampoline, this, CHANGE);
+    // A/B: pulse counter if requested and a unit is free, else interrupts
+    if (backend != EncoderBackend::Pcnt || !pcnt.begin(A, B))
+    {
+        backend = EncoderBackend::Interrupt;
+        attachInterruptArg(digitalPinToInterrupt(A), isrAB_trampoline, this, CHANGE);
+        attachInterruptArg(digitalPinToInterrupt(B), isrAB_trampoline, this, CHANGE);
+    }
     attachInterruptArg(digitalPinToInterrupt(SW), isrSW_trampoline, this, CHANGE);
 }
 
@@ -45,16 +83,33 @@ void IRAM_ATTR Encoder::isrAB_trampoline(void *arg)
 
 void IRAM_ATTR Encoder::isrAB()
 {
-    // Read both quickly
-    uint8_t a = digitalRead(A);
-    uint8_t b = digitalRead(B);
-    uint8_t curr = (a << 1) | b;
-
-    uint8_t idx = (prev << 2) | curr;
-    int8_t delta = QTAB[idx];
+#if ENCODER_ISR_STATS
+    uint32_t start = cycleCount();
+#endif
+
+    // One register read when A and B share a bank (so both are sampled
+    // at the same instant)
+#if defined(ESP32)
+    uint32_t inA = *regA;
+    uint32_t inB = (regB == regA) ? inA : *regB;
+    uint8_t curr = ((inA & maskA) ? 2 : 0) | ((inB & maskB) ? 1 : 0);
+#else
+    uint8_t curr = (digitalRead(A) << 1) | digitalRead(B);
+#endif
+
+    uint8_t p = prev;
+    int8_t delta = QTAB[(p << 2) | curr];
     if (delta)
         quarterCount += delta;
     prev = curr;
+
+#if ENCODER_ISR_STATS
+    // Both bits flipped: an edge was missed and the direction is unknown
+    if ((p ^ curr) == 3)
+        isrStats.invalidAB++;
+    isrStats.abCalls++;
+    recordIsr(start);
+#endif
 }
 
 void IRAM_ATTR Encoder::isrSW_trampoline(void *arg)
@@ -64,27 +119,56 @@ void IRAM_ATTR Encoder::isrSW_trampoline(void *arg)
 
 void IRAM_ATTR Encoder::isrSW()
 {
-    // Raw (bouncy) level; timestamp the latest edge
+#if ENCODER_ISR_STATS
+    uint32_t start = cycleCount();
+#endif
+
+    // Raw (bouncy) level; update() timestamps the edge
+#if defined(ESP32)
+    swRaw = (*regSW & maskSW) != 0;
+#else
     swRaw = digitalRead(SW);
-    swLastEdgeMs = millis();
+#endif
+    swEdge = true;
+
+#if ENCODER_ISR_STATS
+    isrStats.swCalls++;
+    recordIsr(start);
+#endif
 }
 
+#if ENCODER_ISR_STATS
+void IRAM_ATTR Encoder::recordIsr(uint32_t startCycles)
+{
+    uint32_t c = cycleCount() - startCycles;
+    isrStats.cycles += c;
+    if (c > isrStats.maxCycles)
+        isrStats.maxCycles = c;
+}
+#endif
+
 void Encoder::update()
 {
     // Debounce the switch outside ISR
     bool raw;
-    uint32_t edgeTs;
+    bool edge;
 
     noInterrupts();
     raw = swRaw;
-    edgeTs = swLastEdgeMs;
+    edge = swEdge;
+    swEdge = false;
     interrupts();
 
     uint32_t now = millis();
 
+    // Edges are stamped at the first update() after them, which runs every
+    // sampler tick, so the debounce is accurate to one tick
+    if (edge)
+        swLastEdgeMs = now;
+
     if (raw != swStable)
     {
-        if ((uint32_t)(now - edgeTs) >= debounceMs)
+        if ((uint32_t)(now - swLastEdgeMs) >= debounceMs)
         {
             swStable = raw;
             swStableSince = now;
@@ -106,6 +190,9 @@ void Encoder::update()
 
 int32_t Encoder::getQuarterCount()
 {
+    if (backend == EncoderBackend::Pcnt)
+        return pcnt.read();
+
     noInterrupts();
     int32_t q = quarterCount;
     interrupts();
@@ -114,9 +201,7 @@ int32_t Encoder::getQuarterCount()
 
 int32_t Encoder::getDetentCount()
 {
-    noInterrupts();
-    int32_t q = quarterCount;
-    interrupts();
+    int32_t q = getQuarterCount();
     return (detentDiv ? (q / detentDiv) : q);
 }
 
@@ -140,8 +225,29 @@ int32_t Encoder::getScaledDetentCount()
     return (int32_t)(detents * sensitivityPerClick);
 }
 
+EncoderIsrStats Encoder::getIsrStats() const
+{
+    noInterrupts();
+    EncoderIsrStats s = isrStats;
+    interrupts();
+    return s;
+}
+
+void Encoder::resetIsrStats()
+{
+    noInterrupts();
+    isrStats = EncoderIsrStats();
+    interrupts();
+}
+
 void Encoder::reset()
 {
+    if (backend == EncoderBackend::Pcnt)
+    {
+        pcnt.clear();
+        return;
+    }
+
     noInterrupts();
     quarterCount = 0;
     interrupts();
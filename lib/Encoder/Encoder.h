@@ -1,6 +1,30 @@
 #pragma once
 #include <Arduino.h>
 #include <functional>
+#include "PcntUnit.h"
+
+// Cycle-count the encoder ISR bodies (a few cycles each); 0 compiles it out
+#ifndef ENCODER_ISR_STATS
+#define ENCODER_ISR_STATS 1
+#endif
+
+// Where quadrature steps are counted
+enum class EncoderBackend : uint8_t
+{
+    Interrupt, // GPIO CHANGE interrupts on A/B + state table
+    Pcnt       // ESP32 pulse counter, hardware glitch filter, no per-step CPU
+};
+
+// ISR instrumentation. Cycles are CPU cycles from entry to exit of the ISR
+// body (the GPIO dispatcher in front of it isn't included).
+struct EncoderIsrStats
+{
+    uint32_t abCalls = 0;   // A/B edge interrupts
+    uint32_t swCalls = 0;   // button edge interrupts
+    uint64_t cycles = 0;    // total over all calls
+    uint32_t maxCycles = 0; // slowest single call
+    uint32_t invalidAB = 0; // A and B both changed between two ISRs: a step was lost
+};
 
 class Encoder
 {
@@ -11,12 +35,14 @@ public:
             bool useInternalPullups = true,
             uint8_t detentTransitions = 4, // 4 or 2 for most EC11s (quarters per click)
             uint16_t debounceMs = 10,      // switch debounce (ms)
-            float rotations = 1.0f)        // rotations needed to go from 0 to 255 (1.0 = one full rotation, -1 = 1 unit per click)
+            float rotations = 1.0f,        // rotations needed to go from 0 to 255 (1.0 = one full rotation, -1 = 1 unit per click)
+            EncoderBackend backend = EncoderBackend::Interrupt)
         : A(pinA), B(pinB), SW(pinSW),
           usePullups(useInternalPullups),
           detentDiv(detentTransitions),
           debounceMs(debounceMs),
-          rotationsFor255(rotations)
+          rotationsFor255(rotations),
+          backend(backend)
     {
     }
 
@@ -37,6 +63,14 @@ public:
     void setRotations(float r) { rotationsFor255 = r; }
     float getRotations() const { return rotationsFor255; }
 
+    // Requested before begin(); falls back to Interrupt when no PCNT unit is free
+    void setBackend(EncoderBackend b) { backend = b; }
+    EncoderBackend getBackend() const { return backend; }
+
+    // Interrupt backend only; PCNT decodes in hardware
+    EncoderIsrStats getIsrStats() const;
+    void resetIsrStats();
+
     // Button events
     void onPress(Callback cb) { pressCB = cb; }
     void onRelease(Callback cb) { releaseCB = cb; }
@@ -57,17 +91,28 @@ private:
     float rotationsFor255;                              // Number of full rotations to change from 0 to 255
     static constexpr uint8_t DETENTS_PER_ROTATION = 20; // EC11 standard
 
+    // Input registers and bit masks, so the ISRs read GPIO.in directly
+    const volatile uint32_t *regA = nullptr, *regB = nullptr, *regSW = nullptr;
+    uint32_t maskA = 0, maskB = 0, maskSW = 0;
+
     // Quadrature state
+    EncoderBackend backend;
+    PcntUnit pcnt;
     static void IRAM_ATTR isrAB_trampoline(void *arg);
     void IRAM_ATTR isrAB();
     volatile int32_t quarterCount = 0;
     volatile uint8_t prev = 0;
 
-    // Button state
+    // Button state. The ISR only latches the level; update() timestamps
+    // the edge when it sees the flag (it runs every sampler tick)
     static void IRAM_ATTR isrSW_trampoline(void *arg);
     void IRAM_ATTR isrSW();
     volatile bool swRaw = true; // true = released (INPUT_PULLUP)
-    volatile uint32_t swLastEdgeMs = 0;
+    volatile bool swEdge = false;
+    uint32_t swLastEdgeMs = 0;
+
+    EncoderIsrStats isrStats; // written by the ISRs only
+    void IRAM_ATTR recordIsr(uint32_t startCycles);
 
     // Debounced state
     bool swStable = true; // true = released
@@ -0,0 +1,148 @@
+#include "PcntUnit.h"
+
+uint8_t PcntUnit::unitsUsed = 0;
+
+#if defined(ESP32)
+
+bool PcntUnit::serviceInstalled = false;
+
+bool PcntUnit::begin(uint8_t pinA, uint8_t pinB, uint16_t filterCycles)
+{
+    if (unitsUsed >= PCNT_UNITS)
+        return false;
+    unit = (int8_t)unitsUsed++;
+    pcnt_unit_t u = (pcnt_unit_t)unit;
+
+    // Channel 0: A edges, B level sets direction
+    pcnt_config_t cfg = {};
+    cfg.unit = u;
+    cfg.channel = PCNT_CHANNEL_0;
+    cfg.pulse_gpio_num = pinA;
+    cfg.ctrl_gpio_num = pinB;
+    cfg.pos_mode = PCNT_COUNT_DEC;
+    cfg.neg_mode = PCNT_COUNT_INC;
+    cfg.lctrl_mode = PCNT_MODE_REVERSE;
+    cfg.hctrl_mode = PCNT_MODE_KEEP;
+    cfg.counter_h_lim = PCNT_COUNT_LIMIT;
+    cfg.counter_l_lim = -PCNT_COUNT_LIMIT;
+    pcnt_unit_config(&cfg);
+
+    // Channel 1: B edges, A level sets direction
+    cfg.channel = PCNT_CHANNEL_1;
+    cfg.pulse_gpio_num = pinB;
+    cfg.ctrl_gpio_num = pinA;
+    cfg.pos_mode = PCNT_COUNT_INC;
+    cfg.neg_mode = PCNT_COUNT_DEC;
+    pcnt_unit_config(&cfg);
+
+    pcnt_set_filter_value(u, filterCycles);
+    pcnt_filter_enable(u);
+
+    pcnt_event_enable(u, PCNT_EVT_H_LIM);
+    pcnt_event_enable(u, PCNT_EVT_L_LIM);
+    pcnt_counter_pause(u);
+    pcnt_counter_clear(u);
+
+    if (!serviceInstalled)
+    {
+        pcnt_isr_service_install(0);
+        serviceInstalled = true;
+    }
+    pcnt_isr_handler_add(u, isr, this);
+    pcnt_counter_resume(u);
+    return true;
+}
+
+void IRAM_ATTR PcntUnit::isr(void *arg)
+{
+    PcntUnit *self = static_cast<PcntUnit *>(arg);
+    uint32_t status = 0;
+    pcnt_get_event_status((pcnt_unit_t)self->unit, &status);
+
+    // The counter has already reset to 0
+    if (status & PCNT_EVT_H_LIM)
+        self->overflow += PCNT_COUNT_LIMIT;
+    else if (status & PCNT_EVT_L_LIM)
+        self->overflow -= PCNT_COUNT_LIMIT;
+    self->limits++;
+}
+
+int32_t PcntUnit::read() const
+{
+    if (unit < 0)
+        return 0;
+
+    // Retry if a limit event landed between the two reads
+    int32_t ov;
+    int16_t c;
+    do
+    {
+        ov = overflow;
+        pcnt_get_counter_value((pcnt_unit_t)unit, &c);
+    } while (ov != overflow);
+    return ov + c;
+}
+
+void PcntUnit::clear()
+{
+    if (unit < 0)
+        return;
+    pcnt_counter_clear((pcnt_unit_t)unit);
+    overflow = 0;
+}
+
+#else
+
+bool PcntUnit::begin(uint8_t, uint8_t, uint16_t filterCycles)
+{
+    if (unitsUsed >= PCNT_UNITS)
+        return false;
+    unit = (int8_t)unitsUsed++;
+    filter = filterCycles;
+    return true;
+}
+
+int32_t PcntUnit::read() const
+{
+    return overflow + counter;
+}
+
+void PcntUnit::clear()
+{
+    counter = 0;
+    overflow = 0;
+}
+
+void PcntUnit::mockStep(int8_t d)
+{
+    counter += d;
+    if (counter >= PCNT_COUNT_LIMIT || counter <= -PCNT_COUNT_LIMIT)
+    {
+        overflow += counter;
+        counter = 0;
+        limits++;
+    }
+}
+
+void PcntUnit::mockInput(bool a, bool b, uint32_t stableNs)
+{
+    // Filtered out: the counter never sees the change (nor its undo)
+    if ((uint64_t)stableNs * 80 / 1000 < filter)
+        return;
+
+    // Same edge rules as the two hardware channels
+    if (a != levelA)
+    {
+        int8_t d = a ? -1 : +1;
+        mockStep(b ? d : -d);
+    }
+    if (b != levelB)
+    {
+        int8_t d = b ? +1 : -1;
+        mockStep(a ? d : -d);
+    }
+    levelA = a;
+    levelB = b;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+#include <Arduino.h>
+
+#if defined(ESP32)
+#include <driver/pcnt.h>
+#define PCNT_UNITS PCNT_UNIT_MAX
+#else
+#define PCNT_UNITS 8
+#endif
+
+// The hardware counter is 16-bit and resets at its limits; each limit
+// event adds this much to a software extension (the only interrupt left)
+#define PCNT_COUNT_LIMIT 16384
+
+// Glitch filter in APB cycles (80 MHz); 1023 = 12.8 us, the hardware maximum.
+// Shorter pulses (contact chatter, RMT crosstalk) never reach the counter.
+#define PCNT_FILTER_APB_CYCLES 1023
+
+// Quadrature decoding in an ESP32 pulse-counter unit.
+//
+// Both channels count: channel 0 on A edges with B as direction control,
+// channel 1 on B edges with A as control. That gives every A/B edge a step,
+// with the same x4 resolution and sign as the state-table decoder in
+// Encoder::isrAB, and costs no CPU per step.
+//
+// Off the ESP32 the same counting rules, limits and filter are emulated so
+// host code can drive it with mockInput().
+class PcntUnit
+{
+public:
+    // Claims the next free unit; false if all are taken
+    bool begin(uint8_t pinA, uint8_t pinB, uint16_t filterCycles = PCNT_FILTER_APB_CYCLES);
+    bool active() const { return unit >= 0; }
+
+    // Steps since begin()/clear()
+    int32_t read() const;
+    void clear();
+
+    // Limit events so far (each one was an interrupt)
+    uint32_t limitEvents() const { return limits; }
+
+#if !defined(ESP32)
+    // Host mock: A and B changed to these levels and then held them for
+    // stableNs (shorter than the filter window counts as a glitch)
+    void mockInput(bool a, bool b, uint32_t stableNs);
+#endif
+
+private:
+    int8_t unit = -1;
+    volatile int32_t overflow = 0;
+    volatile uint32_t limits = 0;
+
+    static uint8_t unitsUsed;
+
+#if defined(ESP32)
+    static bool serviceInstalled;
+    static void IRAM_ATTR isr(void *arg);
+#else
+    int16_t counter = 0;
+    bool levelA = true, levelB = true; // pulled up at rest
+    uint16_t filter = PCNT_FILTER_APB_CYCLES;
+
+    void mockStep(int8_t d);
+#endif
+};
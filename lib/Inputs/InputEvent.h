@@ -26,8 +26,12 @@ enum class InputAction
     // Toggles (mode-dependent)
     ToggleSecondaryColor, // Enc2 press (only in Default mode)
 
+    // Tempo
+    TapTempo, // Enc1 press + release without turning: tap along with the beat (timeMs = press)
+
     // Navigator (only in Default mode)
     EffectAdjust, // Enc3 rotate
+    SceneStep,    // Enc2 held + Enc3 rotate: step through the preset bank
 
     // Direct mappings
     BrightnessDirect, // Pot scaled 0..255
@@ -36,5 +40,6 @@ enum class InputAction
 struct InputEvent
 {
     InputAction action = InputAction::None;
-    int value = 0; // positive or negative delta, or absolute
+    int value = 0;       // positive or negative delta, or absolute
+    uint32_t timeMs = 0; // when the sampler saw it
 };
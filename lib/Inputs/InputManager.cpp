@@ -18,8 +18,31 @@ void InputManager::begin()
         lastDet[i] = encs[i]->getScaledDetentCount();
     }
     if (pot)
+    {
         pot->begin();
+        lastPot = pot->value8();
+    }
+
+#if defined(ESP32)
+    xTaskCreatePinnedToCore(taskEntry, "input", INPUT_TASK_STACK, this,
+                            INPUT_TASK_PRIORITY, &task, INPUT_TASK_CORE);
+#endif
+}
+
+#if defined(ESP32)
+void InputManager::taskEntry(void *arg)
+{
+    InputManager *self = static_cast<InputManager *>(arg);
+
+    // Fixed rate: the wake time advances by exactly one period per tick
+    TickType_t wake = xTaskGetTickCount();
+    for (;;)
+    {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(INPUT_SAMPLE_PERIOD_MS));
+        self->sample();
+    }
 }
+#endif
 
 // Maps enc rotation + (hold state) → action
 InputAction InputManager::actionFor(uint8_t enc, bool hold)
@@ -30,8 +53,8 @@ InputAction InputManager::actionFor(uint8_t enc, bool hold)
         return hold ? InputAction::MainSatAdjust : InputAction::MainHueAdjust;
     case 1: // Enc2
         return hold ? InputAction::SecondarySatAdjust : InputAction::SecondaryHueAdjust;
-    case 2: // Enc3
-        return InputAction::EffectAdjust;
+    case 2: // Enc3 (with Enc2 held: scenes)
+        return btn[1].pressed ? InputAction::SceneStep : InputAction::EffectAdjust;
     case 3: // Enc4
         return InputAction::IntensityAdjust;
     case 4: // Enc5
@@ -41,6 +64,40 @@ InputAction InputManager::actionFor(uint8_t enc, bool hold)
     }
 }
 
+// Maps button press → mode activation (fires immediately)
+InputAction InputManager::pressActionFor(uint8_t enc)
+{
+    switch (enc)
+    {
+    case 2: // Enc3: Enter Special3 (emergency)
+        return InputAction::EnterSpecial3;
+    case 3: // Enc4: Enter Special2
+        return InputAction::EnterSpecial2;
+    case 4: // Enc5: Enter Special1 (strobe)
+        return InputAction::EnterSpecial1;
+    default:
+        return InputAction::None;
+    }
+}
+
+// Maps button release → mode deactivation, or a short-press toggle
+InputAction InputManager::releaseActionFor(uint8_t enc)
+{
+    switch (enc)
+    {
+    case 0: // Enc1: Tap tempo (not after press-and-turn, which is saturation)
+        return InputAction::TapTempo;
+    case 2: // Enc3: Exit Special3
+        return InputAction::ExitSpecial3;
+    case 3: // Enc4: nothing on release
+        return InputAction::None;
+    case 4: // Enc5: Exit Special1
+        return InputAction::ExitSpecial1;
+    default:
+        return toggleActionFor(enc);
+    }
+}
+
 // Maps button press events → toggles
 InputAction InputManager::toggleActionFor(uint8_t enc)
 {
@@ -53,13 +110,62 @@ InputAction InputManager::toggleActionFor(uint8_t enc)
     }
 }
 
-bool InputManager::poll(InputEvent &e)
+// Relative adjustments and the absolute pot value can be merged
+bool InputManager::mergeable(InputAction action)
 {
-    e.action = InputAction::None;
-    e.value = 0;
+    switch (action)
+    {
+    case InputAction::MainHueAdjust:
+    case InputAction::MainSatAdjust:
+    case InputAction::SecondaryHueAdjust:
+    case InputAction::SecondarySatAdjust:
+    case InputAction::IntensityAdjust:
+    case InputAction::SpeedAdjust:
+    case InputAction::EffectAdjust:
+    case InputAction::SceneStep:
+    case InputAction::BrightnessDirect:
+        return true;
+    default:
+        return false;
+    }
+}
 
+bool InputManager::emit(InputAction action, int value, uint32_t now)
+{
+    InputEvent e;
+    e.action = action;
+    e.value = value;
+    e.timeMs = now;
+    return queue.push(e);
+}
+
+// Every state change below is only committed once its event is queued, so
+// a full queue delays an event to the next tick instead of losing it
+void InputManager::sample()
+{
+    uint32_t t0 = micros();
     uint32_t now = millis();
 
+    checkSaveCombo(now);
+    for (uint8_t i = 0; i < count; i++)
+        checkEncoder(i, now);
+    checkPot(now);
+
+    // The consumer sees this tick's events together
+    queue.publish();
+
+    uint32_t us = micros() - t0;
+    sampleUs = us;
+    if (us > maxUs)
+        maxUs = us;
+    if (tickCount && t0 - lastTickUs > maxGapUs)
+        maxGapUs = t0 - lastTickUs;
+    lastTickUs = t0;
+    tickCount = tickCount + 1;
+}
+
+void InputManager::checkSaveCombo(uint32_t now)
+{
     // Check for save combo (Enc4 + Enc5 both pressed for 5s)
     bool enc4Pressed = (encs[3]->getButtonStateRaw() == LOW);
     bool enc5Pressed = (encs[4]->getButtonStateRaw() == LOW);
@@ -74,112 +180,101 @@ bool InputManager::poll(InputEvent &e)
         else if (now - saveComboStartTime >= SAVE_HOLD_TIME)
         {
             // Trigger save (only once)
-            e.action = InputAction::SaveConfigs;
-            e.value = 1;
-            saveComboActive = false; // Prevent repeated triggers
-            return true;
+            if (emit(InputAction::SaveConfigs, 1, now))
+                saveComboActive = false; // Prevent repeated triggers
         }
     }
     else
     {
         saveComboActive = false;
     }
+}
 
-    // Check encoders
-    for (uint8_t i = 0; i < count; i++)
-    {
-        encs[i]->update();
+void InputManager::checkEncoder(uint8_t i, uint32_t now)
+{
+    encs[i]->update();
 
-        bool sw = (encs[i]->getButtonStateRaw() == LOW);
+    bool sw = (encs[i]->getButtonStateRaw() == LOW);
 
-        // Press detection (fires immediately)
-        if (sw && !btn[i].pressed)
+    // Press detection (fires immediately)
+    if (sw && !btn[i].pressed)
+    {
+        InputAction a = pressActionFor(i);
+        if (a == InputAction::None || emit(a, 1, now))
         {
             btn[i].pressed = true;
             btn[i].pressTime = now;
-
-            // Mode activation on press
-            if (i == 3) // Enc4: Enter Special2
-            {
-                e.action = InputAction::EnterSpecial2;
-                e.value = 1;
-                return true;
-            }
-            else if (i == 4) // Enc5: Enter Special1 (strobe)
-            {
-                e.action = InputAction::EnterSpecial1;
-                e.value = 1;
-                return true;
-            }
-            else if (i == 2) // Enc3: Enter Special3 (emergency)
-            {
-                e.action = InputAction::EnterSpecial3;
-                e.value = 1;
-                return true;
-            }
         }
+    }
 
-        // Release detection
-        if (!sw && btn[i].pressed)
-        {
-            // Mode deactivation on release
-            if (i == 4) // Enc5: Exit Special1
-            {
-                e.action = InputAction::ExitSpecial1;
-                e.value = 0;
-                btn[i] = {};
-                return true;
-            }
-            else if (i == 2) // Enc3: Exit Special3
-            {
-                e.action = InputAction::ExitSpecial3;
-                e.value = 0;
-                btn[i] = {};
-                return true;
-            }
-
-            // Other buttons: short-press toggles (non-mode buttons)
-            if (i != 3 && i != 4 && i != 2) // Not Enc3, Enc4, or Enc5
-            {
-                InputAction a = toggleActionFor(i);
-                if (a != InputAction::None)
-                {
-                    e.action = a;
-                    e.value = 1;
-                    btn[i] = {};
-                    return true;
-                }
-            }
-
+    // Release detection
+    if (!sw && btn[i].pressed)
+    {
+        InputAction a = btn[i].chorded ? InputAction::None : releaseActionFor(i);
+        int value = (a == InputAction::ExitSpecial1 || a == InputAction::ExitSpecial3) ? 0 : 1;
+        // A tap is decided on release but lands on the beat when pressed
+        uint32_t at = a == InputAction::TapTempo ? btn[i].pressTime : now;
+        if (a == InputAction::None || emit(a, value, at))
             btn[i] = {};
-        }
+    }
 
-        // Rotational deltas
-        int32_t det = encs[i]->getScaledDetentCount();
-        int delta = det - lastDet[i];
-        if (delta != 0)
-        {
-            lastDet[i] = det;
-            InputAction a = actionFor(i, btn[i].pressed);
-            e.action = a;
-            e.value = delta;
-            return true;
-        }
+    // Rotational deltas (hold state decides the action)
+    int32_t det = encs[i]->getScaledDetentCount();
+    int delta = det - lastDet[i];
+    if (delta == 0)
+        return;
+    InputAction a = actionFor(i, btn[i].pressed);
+    if (emit(a, delta, now))
+    {
+        lastDet[i] = det;
+        if (a == InputAction::SceneStep)
+            btn[1].chorded = true;
+        else if (a == InputAction::MainSatAdjust)
+            btn[0].chorded = true;
     }
+}
 
-    // Pot polling
-    if (pot)
+void InputManager::checkPot(uint32_t now)
+{
+    if (!pot)
+        return;
+
+    // The pot's hysteresis already keeps value8() still, so any change is
+    // real; lastPot only covers a change that didn't fit the queue
+    pot->sample();
+    uint8_t v = pot->value8();
+    if (v != lastPot && emit(InputAction::BrightnessDirect, v, now))
+        lastPot = v;
+}
+
+uint8_t InputManager::drain(InputEvent *out, uint8_t max)
+{
+    uint8_t n = 0;
+    uint8_t mergeFrom = 0; // never merge across a mode/button event
+    InputEvent e;
+
+    while (n < max && queue.pop(e))
     {
-        pot->update();
-        uint8_t v = pot->value8();
-        if (abs((int)v - (int)lastPot) >= 2)
+        if (!mergeable(e.action))
         {
-            lastPot = v;
-            e.action = InputAction::BrightnessDirect;
-            e.value = v;
-            return true;
+            out[n++] = e;
+            mergeFrom = n;
+            continue;
         }
-    }
 
-    return false;
+        bool merged = false;
+        for (uint8_t k = mergeFrom; k < n; k++)
+        {
+            if (out[k].action != e.action)
+                continue;
+            // Deltas add up; the pot is absolute, so the latest value wins
+            out[k].value = e.action == InputAction::BrightnessDirect ? e.value : out[k].value + e.value;
+            out[k].timeMs = e.timeMs;
+            merged = true;
+            break;
+        }
+        if (!merged)
+            out[n++] = e;
+    }
+    return n;
 }
@@ -2,21 +2,65 @@
 #include <Arduino.h>
 #include <Encoder.h>
 #include "InputEvent.h"
+#include "InputQueue.h"
 #include "Pot.h"
 
+// Sampler tick. Encoders, buttons and the pot ADC are sampled every tick.
+#define INPUT_SAMPLE_PERIOD_MS 1
+
+// Sampler task: core 0, above the LED show and audio tasks, so neither the
+// render loop (core 1) nor a frame transmission can hold a tick back. A
+// tick takes a few microseconds.
+#define INPUT_TASK_CORE 0
+#define INPUT_TASK_PRIORITY 3
+#define INPUT_TASK_STACK 3072
+
+// Events buffered between two frames (one slot is always kept free)
+#define INPUT_QUEUE_SIZE 32
+
 // Holds press/hold state tracking per encoder
 struct ButtonState
 {
     bool pressed = false;
     uint32_t pressTime = 0;
+    bool chorded = false; // turned while held, or a modifier for another encoder: no release action
 };
 
+// Turns encoder, button and pot changes into InputEvents.
+// A 1 kHz sampler task debounces the inputs and produces the events into a
+// lock-free queue, one published batch per tick; loop() drains the whole
+// queue once per frame, so no control waits behind another and detection
+// latency doesn't depend on frame time.
 class InputManager
 {
 public:
     InputManager(Encoder **encList, uint8_t count, Pot *pot);
+
+    // Sets up the inputs and starts the sampler task on the ESP32
     void begin();
-    bool poll(InputEvent &e); // returns true if event is produced
+
+    // Producer: checks every encoder, button, the save combo and the pot
+    // and queues one event per change. Runs on the sampler tick; call it
+    // directly where there is no task.
+    void sample();
+
+    // Consumer: moves all queued events into out (at most max), in order.
+    // Repeated adjustments of the same control since the last mode/button
+    // event are merged into one. Returns the number of events.
+    uint8_t drain(InputEvent *out, uint8_t max);
+
+    uint32_t droppedEvents() const { return queue.overflowCount(); }
+
+    // Sampler timing: ticks run, time spent in one, and the longest time
+    // between two (the worst-case delay before a change is seen)
+    uint32_t ticks() const { return tickCount; }
+    uint32_t lastSampleUs() const { return sampleUs; }
+    uint32_t maxSampleUs() const { return maxUs; }
+    uint32_t maxTickGapUs() const { return maxGapUs; }
+    void resetStats() { maxUs = maxGapUs = 0; }
+
+    uint8_t encoderCount() const { return count; }
+    Encoder &encoder(uint8_t i) const { return *encs[i]; }
 
 private:
     Encoder **encs;
@@ -32,9 +76,27 @@ private:
     uint32_t saveComboStartTime = 0;
     bool saveComboActive = false;
 
-    void checkEncoder(uint8_t i, InputEvent &e);
-    void checkPot(InputEvent &e);
+    InputQueue<INPUT_QUEUE_SIZE> queue;
+
+    volatile uint32_t tickCount = 0;
+    volatile uint32_t sampleUs = 0;
+    volatile uint32_t maxUs = 0;
+    volatile uint32_t maxGapUs = 0;
+    uint32_t lastTickUs = 0;
+
+    bool emit(InputAction action, int value, uint32_t now);
+    void checkSaveCombo(uint32_t now);
+    void checkEncoder(uint8_t i, uint32_t now);
+    void checkPot(uint32_t now);
 
     InputAction actionFor(uint8_t encIndex, bool hold);
+    InputAction pressActionFor(uint8_t encIndex);
+    InputAction releaseActionFor(uint8_t encIndex);
     InputAction toggleActionFor(uint8_t encIndex);
+    static bool mergeable(InputAction action);
+
+#if defined(ESP32)
+    TaskHandle_t task = nullptr;
+    static void taskEntry(void *arg);
+#endif
 };
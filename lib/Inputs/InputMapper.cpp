@@ -14,24 +14,30 @@ bool InputMapper::apply(const InputEvent &e, LightingParams &P)
     // Adjustments routed to activeConfig
     case InputAction::MainHueAdjust:
         P.activeConfig->mainHue += e.value;
+        P.activeConfig->touch();
         break;
     case InputAction::MainSatAdjust:
         P.activeConfig->mainSat = constrain(P.activeConfig->mainSat + e.value, 0, 255);
+        P.activeConfig->touch();
         break;
 
     case InputAction::SecondaryHueAdjust:
         P.activeConfig->secondaryHue += e.value;
+        P.activeConfig->touch();
         break;
     case InputAction::SecondarySatAdjust:
         P.activeConfig->secondarySat = constrain(P.activeConfig->secondarySat + e.value, 0, 255);
+        P.activeConfig->touch();
         break;
 
     case InputAction::IntensityAdjust:
         P.activeConfig->intensity = constrain(P.activeConfig->intensity + e.value, 0, 255);
+        P.activeConfig->touch();
         break;
 
     case InputAction::SpeedAdjust:
         P.activeConfig->speed = constrain(P.activeConfig->speed + e.value, 0, 255);
+        P.activeConfig->touch();
         break;
 
     // Effect switching (only in Default mode)
@@ -47,6 +53,7 @@ bool InputMapper::apply(const InputEvent &e, LightingParams &P)
         if (P.activeMode == ConfigMode::Default)
         {
             P.activeConfig->secondaryEnabled = !P.activeConfig->secondaryEnabled;
+            P.activeConfig->touch();
             Serial.printf("Secondary: %s\n", P.activeConfig->secondaryEnabled ? "ON" : "OFF");
         }
         break;
@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include "InputEvent.h"
+
+// Lock-free single-producer / single-consumer ring of InputEvents.
+// The input sampler pushes and loop() pops; head is only written by the
+// producer and tail only by the consumer, so neither side ever blocks.
+// Pushed events stay invisible to the consumer until publish(), so it
+// always sees whole sampler ticks, never half of one.
+// N must be a power of two; one slot stays empty to tell full from empty.
+template <uint8_t N>
+class InputQueue
+{
+    static_assert(N && (N & (N - 1)) == 0, "InputQueue size must be a power of two");
+
+public:
+    // Producer side; false (and counted) when full
+    bool push(const InputEvent &e)
+    {
+        uint8_t next = (staged + 1) & (N - 1);
+        if (next == tail.load(std::memory_order_acquire))
+        {
+            overflows++;
+            return false;
+        }
+        buf[staged] = e;
+        staged = next;
+        return true;
+    }
+
+    // Producer side: makes everything pushed so far visible
+    void publish() { head.store(staged, std::memory_order_release); }
+
+    // Consumer side
+    bool pop(InputEvent &e)
+    {
+        uint8_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+        e = buf[t];
+        tail.store((t + 1) & (N - 1), std::memory_order_release);
+        return true;
+    }
+
+    uint32_t overflowCount() const { return overflows; }
+
+private:
+    InputEvent buf[N];
+    std::atomic<uint8_t> head{0};
+    uint8_t staged = 0; // producer's write position, ahead of head
+    std::atomic<uint8_t> tail{0};
+    volatile uint32_t overflows = 0;
+};
@@ -1,2 +1,63 @@
 #include "Pot.h"
-// (All inline for simplicity — nothing needed here.)
+
+static uint16_t median3(uint16_t a, uint16_t b, uint16_t c)
+{
+    if (a > b)
+        std::swap(a, b);
+    if (b > c)
+        b = c;
+    return a > b ? a : b;
+}
+
+void Pot::begin()
+{
+    analogReadResolution(bits);
+    analogSetPinAttenuation(pin, attn);
+
+    // Start settled on the current position
+    uint16_t v = analogRead(pin);
+    for (uint8_t i = 0; i < 3; i++)
+        blocks[i] = v;
+    acc = 0;
+    accCount = 0;
+    filtered = v;
+    out = (uint8_t)(((uint32_t)v * 255 + ((1u << bits) - 1) / 2) / ((1u << bits) - 1));
+}
+
+bool Pot::sample()
+{
+    acc += analogRead(pin);
+    if (++accCount < POT_OVERSAMPLE)
+        return false;
+
+    uint16_t block = (uint16_t)(acc / POT_OVERSAMPLE);
+    acc = 0;
+    accCount = 0;
+
+    blocks[blockIdx] = block;
+    blockIdx = blockIdx == 2 ? 0 : blockIdx + 1;
+    filtered = median3(blocks[0], blocks[1], blocks[2]);
+    return apply(filtered);
+}
+
+// Hysteresis in Q8 of the 8-bit scale: the value moves only once the
+// reading is more than half a step plus POT_HYSTERESIS_Q8 from its centre
+bool Pot::apply(uint16_t raw)
+{
+    uint32_t fullScale = (1u << bits) - 1;
+    int32_t q = (int32_t)((uint32_t)raw * (255u << 8) / fullScale);
+    uint8_t target = (uint8_t)((q + 128) >> 8);
+    int32_t dist = q - ((int32_t)out << 8);
+    if (dist < 0)
+        dist = -dist;
+
+    // The ends are always reachable, hysteresis or not
+    bool end = (target == 0 || target == 255) && target != out;
+    if (dist <= 128 + POT_HYSTERESIS_Q8 && !end)
+        return false;
+
+    out = target;
+    if (changeCB)
+        changeCB(out);
+    return true;
+}
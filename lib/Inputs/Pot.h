@@ -1,51 +1,55 @@
 #pragma once
 #include <Arduino.h>
+#include <functional>
 
+// Raw ADC samples summed per output block (power of two); at one sample
+// per input tick that's a new block every 8 ms
+#define POT_OVERSAMPLE 8
+
+// How far past the edge of the current 8-bit step the reading has to move
+// before the value changes, in 1/256 steps. Keeps the output still when
+// the wiper sits between two steps.
+#define POT_HYSTERESIS_Q8 192
+
+// Fader on an ADC pin, filtered in integers:
+// oversampling (sum of POT_OVERSAMPLE reads) -> median of the last three
+// blocks (drops single spikes) -> hysteresis on the 8-bit output.
+//
+// sample() does one ADC read and is meant for a fixed-rate caller (the
+// input task), so the render loop never waits on the ADC.
 class Pot
 {
 public:
-    Pot(uint8_t pin, uint8_t resolutionBits = 12, adc_attenuation_t attn = ADC_11db,
-        float alpha = 0.12f)
-        : pin(pin), bits(resolutionBits), attn(attn), alpha(alpha) {}
-
-    void begin()
-    {
-        analogReadResolution(bits);
-        analogSetPinAttenuation(pin, attn);
-        smooth = analogRead(pin);
-        lastReported = -10000;
-    }
-
-    void update()
-    {
-        float v = analogRead(pin);
-        smooth = (1.0f - alpha) * smooth + alpha * v;
-    }
-
-    uint16_t valueRaw() const { return (uint16_t)(smooth + 0.5f); }
-
-    uint8_t value8() const
-    {
-        float maxV = (float)((1U << bits) - 1);
-        return (uint8_t)((smooth / maxV) * 255.0f + 0.5f);
-    }
-
-    bool changed(uint16_t delta = 8)
-    {
-        uint16_t cur = valueRaw();
-        if (abs((int)cur - (int)lastReported) >= (int)delta)
-        {
-            lastReported = cur;
-            return true;
-        }
-        return false;
-    }
+    using Callback = std::function<void(uint8_t)>;
+
+    Pot(uint8_t pin, uint8_t resolutionBits = 12, adc_attenuation_t attn = ADC_11db)
+        : pin(pin), bits(resolutionBits), attn(attn) {}
+
+    void begin();
+
+    // One ADC read; true when value8() changed
+    bool sample();
+
+    uint16_t valueRaw() const { return filtered; } // resolutionBits wide
+    uint8_t value8() const { return out; }
+
+    // Called from sample() with the new value8()
+    void onChange(Callback cb) { changeCB = cb; }
 
 private:
     uint8_t pin;
     uint8_t bits;
     adc_attenuation_t attn;
-    float alpha;
-    float smooth = 0;
-    float lastReported;
+
+    uint32_t acc = 0;
+    uint8_t accCount = 0;
+    uint16_t blocks[3] = {};
+    uint8_t blockIdx = 0;
+
+    uint16_t filtered = 0;
+    uint8_t out = 0;
+
+    Callback changeCB = nullptr;
+
+    bool apply(uint16_t raw);
 };
@@ -1,23 +1,247 @@
 #include "LedEngine.h"
 
-LedEngine::LedEngine(CRGB *mainBuf, uint16_t mc,
-                     CRGB *detailBuf, uint16_t dc)
-    : mainLeds(mainBuf), nMain(mc),
-      detailLeds(detailBuf), nDetail(dc)
+LedEngine::LedEngine(uint16_t mc, uint16_t dc)
+    : nMain(mc), nDetail(dc)
 {
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        mainBuf[i].resize(nMain);
+        detailBuf[i].resize(nDetail);
+    }
+    mainLeds = mainBuf[back].data();
+    detailLeds = detailBuf[back].data();
+
+    wireMain.resize(nMain);
+    wireDetail.resize(nDetail);
+    residue.resize(((size_t)nMain + nDetail) * 3);
+}
+
+void LedEngine::begin(LedTransport *t, bool threaded)
+{
+    transport = t;
+    transport->begin(wireMain.data(), nMain, wireDetail.data(), nDetail);
+
+#if defined(ESP32)
+    if (threaded)
+    {
+        // Binary semaphore starts "given": no frame in flight yet
+        showDone = xSemaphoreCreateBinary();
+        xSemaphoreGive(showDone);
+        xTaskCreatePinnedToCore(showTaskEntry, "ledShow", LED_SHOW_TASK_STACK, this,
+                                LED_SHOW_TASK_PRIORITY, &showTask, LED_SHOW_TASK_CORE);
+    }
+#else
+    (void)threaded;
+#endif
+}
+
+void LedEngine::setPowerLimit(uint16_t ma)
+{
+    powerLimitMa = ma;
+}
+
+void LedEngine::setPowerModel(LedStrip strip, const LedPowerModel &model)
+{
+    stripModel[(uint8_t)strip] = model;
+}
+
+void LedEngine::setFrameDiff(bool enabled, uint32_t keepAlive)
+{
+    diffEnabled = enabled;
+    keepAliveMs = keepAlive;
+    haveSent = false;
+}
+
+// One pass per strip: FNV-1a frame hash and per-channel sums for the power model
+static void scanStrip(const CRGB *leds, uint16_t n, uint32_t &h, uint32_t sum[3])
+{
+    uint32_t r = 0, g = 0, b = 0;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        const CRGB &c = leds[i];
+        h = (h ^ c.r) * 16777619u;
+        h = (h ^ c.g) * 16777619u;
+        h = (h ^ c.b) * 16777619u;
+        r += c.r;
+        g += c.g;
+        b += c.b;
+    }
+    sum[0] = r;
+    sum[1] = g;
+    sum[2] = b;
+}
+
+// Draw at full brightness (excluding idle) for one strip, in microamps
+static uint64_t variableUa(const uint32_t sum[3], const LedPowerModel &m)
+{
+    return ((uint64_t)sum[0] * m.redUa + (uint64_t)sum[1] * m.greenUa +
+            (uint64_t)sum[2] * m.blueUa) / 255;
+}
+
+uint16_t LedEngine::limitPower(uint64_t varUa, uint32_t idleUa)
+{
+    uint64_t requested = varUa * brightness / 65535;
+    uint8_t target = 255;
+
+    if (powerLimitMa && requested + idleUa > (uint64_t)powerLimitMa * 1000)
+    {
+        uint32_t budgetUa = (uint32_t)powerLimitMa * 1000;
+        uint64_t avail = budgetUa > idleUa ? budgetUa - idleUa : 0;
+        // A black frame over budget on idle draw alone: nothing to scale
+        target = requested ? (uint8_t)(avail * 255 / requested) : 0;
+    }
+
+    // Drop at once, recover gradually so a flickering effect doesn't pump
+    if (target < powerScale)
+        powerScale = target;
+    else
+        powerScale += (target - powerScale + LED_POWER_RELEASE_DIV - 1) / LED_POWER_RELEASE_DIV;
+
+    uint16_t b = (uint16_t)(((uint32_t)brightness * powerScale) / 255);
+    drawMa = (uint16_t)((idleUa + varUa * b / 65535) / 1000);
+    return b;
+}
+
+bool LedEngine::present()
+{
+    uint8_t idx = back;
+    uint32_t sig = 2166136261u;
+    bool lit;
+
+    {
+        ProfileScope scope(profiler, ProfileStage::Power);
+        uint32_t mainSum[3], detailSum[3];
+        scanStrip(mainBuf[idx].data(), nMain, sig, mainSum);
+        scanStrip(detailBuf[idx].data(), nDetail, sig, detailSum);
+
+        const LedPowerModel &mm = stripModel[(uint8_t)LedStrip::Main];
+        const LedPowerModel &dm = stripModel[(uint8_t)LedStrip::Detail];
+        uint64_t varUa = variableUa(mainSum, mm) + variableUa(detailSum, dm);
+        uint32_t idleUa = (uint32_t)nMain * mm.idleUa + (uint32_t)nDetail * dm.idleUa;
+        frameBrightness[idx] = limitPower(varUa, idleUa);
+        lit = mainSum[0] | mainSum[1] | mainSum[2] | detailSum[0] | detailSum[1] | detailSum[2];
+    }
+
+    // Decided from this frame: any lit pixel below full brightness has a
+    // fractional level for the dither to carry
+    bool dithers = ditherEnabled && lit && frameBrightness[idx] < 65535;
+
+    sig = (sig ^ (frameBrightness[idx] & 0xFF)) * 16777619u;
+    sig = (sig ^ (frameBrightness[idx] >> 8)) * 16777619u;
+
+    if (diffEnabled)
+    {
+        uint32_t now = millis();
+        bool stale = keepAliveMs && (now - lastSentMs >= keepAliveMs);
+        if (haveSent && sig == lastSig && !stale && !dithers)
+        {
+            skippedCount++;
+            return false;
+        }
+        lastSig = sig;
+        lastSentMs = now;
+        haveSent = true;
+    }
+
+#if defined(ESP32)
+    if (showTask)
+    {
+        // Wait until frame N-1 is on the wire: its buffer becomes our next back buffer
+        uint32_t t0 = micros();
+        xSemaphoreTake(showDone, portMAX_DELAY);
+        waitUs = micros() - t0;
+        recordShowTimings();
+
+        front = idx;
+        back = idx ^ 1;
+        mainLeds = mainBuf[back].data();
+        detailLeds = detailBuf[back].data();
+
+        xTaskNotifyGive(showTask);
+        return true;
+    }
+#endif
+
+    // Synchronous path: show in place, keep rendering into the same buffer
+    front = idx;
+    showFrame(idx);
+    recordShowTimings();
+    return true;
+}
+
+// out = src * bright16 / 65536, with the fraction carried per channel
+// from frame to frame
+void LedEngine::scaleOut(const CRGB *src, CRGB *dst, uint8_t *res, uint16_t n, uint16_t bright16)
+{
+    const uint32_t scale = (uint32_t)bright16 + 1; // 65535 -> exact 1.0
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        for (uint8_t ch = 0; ch < 3; ch++)
+        {
+            uint32_t v = src[i].raw[ch] * scale; // 8.16 fixed point
+            uint8_t out = v >> 16;
+            uint8_t f = (uint8_t)(v >> 8);
+            if (ditherEnabled)
+            {
+                uint16_t acc = (uint16_t)f + *res;
+                out += acc >> 8;
+                *res = (uint8_t)acc;
+            }
+            res++;
+            dst[i].raw[ch] = out;
+        }
+    }
+}
+
+void LedEngine::showFrame(uint8_t idx)
+{
+    uint32_t c0 = FrameProfiler::cycles();
+    uint16_t b = frameBrightness[idx];
+    scaleOut(mainBuf[idx].data(), wireMain.data(), residue.data(), nMain, b);
+    scaleOut(detailBuf[idx].data(), wireDetail.data(), residue.data() + nMain * 3, nDetail, b);
+
+    uint32_t c1 = FrameProfiler::cycles();
+    uint32_t t0 = micros();
+    transport->show(wireMain.data(), wireDetail.data(), 255);
+    showUs = micros() - t0;
+
+    ditherCycles = c1 - c0;
+    showCycles = FrameProfiler::cycles() - c1;
+    timingsPending = true;
+    shownCount++;
+}
+
+// loop()'s core only: after showDone was taken (or the synchronous show),
+// so the show task is done writing the timings
+void LedEngine::recordShowTimings()
+{
+    if (!timingsPending)
+        return;
+    timingsPending = false;
+    if (profiler)
+    {
+        profiler->record(ProfileStage::Dither, ditherCycles);
+        profiler->record(ProfileStage::Show, showCycles);
+    }
 }
 
-void LedEngine::begin()
+#if defined(ESP32)
+void LedEngine::showTaskEntry(void *arg)
 {
-    // Use compile-time #defines from main.cpp
-    FastLED.addLeds<WS2812B, LED_PIN_MAIN, LED_TYPE_MAIN>(mainLeds, nMain);
-    FastLED.addLeds<WS2812B, LED_PIN_DETAIL, LED_TYPE_DETAIL>(detailLeds, nDetail);
+    static_cast<LedEngine *>(arg)->showLoop();
 }
 
-void LedEngine::setPowerLimit(uint8_t volts, uint16_t ma)
+void LedEngine::showLoop()
 {
-    FastLED.setMaxPowerInVoltsAndMilliamps(volts, ma);
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        showFrame(front);
+        xSemaphoreGive(showDone);
+    }
 }
+#endif
 
 void LedEngine::clearAll()
 {
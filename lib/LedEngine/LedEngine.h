@@ -1,23 +1,141 @@
 #pragma once
 #include <FastLED.h>
+#include <vector>
+#include "LedTransport.h"
+#include "LedGamma.h"
+#include "FrameProfiler.h"
 
-#define LED_PIN_MAIN 27
-#define LED_PIN_DETAIL 26
-#define LED_TYPE_MAIN BRG
-#define LED_TYPE_DETAIL GRB
+// Show task placement: Arduino's loop() runs on core 1, so transmission
+// gets core 0 and the next frame renders while the current one is sent.
+#define LED_SHOW_TASK_CORE 0
+#define LED_SHOW_TASK_PRIORITY 2
+#define LED_SHOW_TASK_STACK 4096
+
+// Unchanged frames are not re-sent, but the strips still get a refresh this
+// often so a glitched pixel or a hot-plugged strip doesn't stay wrong
+#define LED_KEEPALIVE_MS 1000
+
+// Current draw of one pixel, in microamps, per channel at full value plus
+// the quiescent draw of its driver IC. Channels are in logical RGB order;
+// the strip's wire order (BRG/GRB) doesn't change what each colour draws.
+struct LedPowerModel
+{
+    uint16_t redUa;
+    uint16_t greenUa;
+    uint16_t blueUa;
+    uint16_t idleUa;
+};
+
+// WS2812B starting values (same as FastLED's power model). Replace with
+// numbers measured on the totem's strips via setPowerModel().
+#define LED_POWER_MODEL_WS2812B {16000, 11000, 15000, 1000}
+
+// When the budget allows more brightness again, the limiter closes 1/N of
+// the gap per frame; it always drops immediately when over budget
+#define LED_POWER_RELEASE_DIV 8
+
+enum class LedStrip : uint8_t
+{
+    Main = 0,
+    Detail
+};
 
 class LedEngine
 {
 public:
-    LedEngine(CRGB *mainBuf, uint16_t mainCount,
-              CRGB *detailBuf, uint16_t detailCount);
+    LedEngine(uint16_t mainCount, uint16_t detailCount);
+
+    // threaded = false keeps present() synchronous (host builds always are)
+    void begin(LedTransport *transport, bool threaded = true);
+    // Current budget for the whole strip supply (0 mA = unlimited); the
+    // model is in current only, the strips run off a fixed 5V rail.
+    // Brightness is scaled down per frame to keep the modelled draw under it.
+    void setPowerLimit(uint16_t milliamps);
+    void setPowerModel(LedStrip strip, const LedPowerModel &model);
+    // Perceptual brightness (0-255); gamma-mapped to a 16-bit linear scale
+    void setBrightness(uint8_t b) { brightness = LED_GAMMA16[b]; }
+    void setDither(bool on) { ditherEnabled = on; }
+
+    // Power is recorded in present(). The show task only stores its Dither
+    // and Show times; present() records them once it has taken showDone,
+    // so the profiler is only ever written from loop()'s core.
+    void setProfiler(FrameProfiler *p) { profiler = p; }
 
-    void begin();
-    void setPowerLimit(uint8_t volts, uint16_t milliamps);
+    // Skip transmission of frames identical to the last one sent
+    // (pixels and final brightness). keepAliveMs = 0 never refreshes.
+    void setFrameDiff(bool enabled, uint32_t keepAliveMs = LED_KEEPALIVE_MS);
 
+    // Output pass (show task): pixel * 16-bit brightness, temporally
+    // dithered down to 8 bits into the wire buffers in one loop. A lit
+    // frame below full brightness (slider or power limiter) is dithered
+    // and so never skipped, or dim static scenes would freeze on one
+    // rounding; only black frames and unchanged full-brightness frames are.
+
+    // Hand the back buffer to the show task and swap to the other one.
+    // Blocks only while the previous frame is still being transmitted.
+    // Returns false if the frame was unchanged and not sent; the render
+    // target then stays the same buffer.
+    bool present();
+
+    // Render target for the next frame (changes on every present())
     CRGB *mainLeds;
     CRGB *detailLeds;
     uint16_t nMain, nDetail;
 
     void clearAll();
+
+    // Pipeline stats
+    uint32_t framesShown() const { return shownCount; }
+    uint32_t framesSkipped() const { return skippedCount; }
+    uint32_t lastShowUs() const { return showUs; }        // transport time of last frame
+    uint32_t lastPresentWaitUs() const { return waitUs; } // time present() blocked
+    uint16_t lastDrawMa() const { return drawMa; }        // modelled draw of last frame
+    uint8_t lastPowerScale() const { return powerScale; } // 255 = not limited
+
+private:
+    std::vector<CRGB> mainBuf[2];
+    std::vector<CRGB> detailBuf[2];
+    uint16_t frameBrightness[2] = {65535, 65535};
+    uint8_t back = 0;
+    volatile uint8_t front = 1;
+    uint16_t brightness = 65535;
+
+    // Show-task side: what goes on the wire, plus the per-channel dither residue
+    std::vector<CRGB> wireMain;
+    std::vector<CRGB> wireDetail;
+    std::vector<uint8_t> residue;
+    bool ditherEnabled = true;
+    uint16_t powerLimitMa = 0;
+    uint8_t powerScale = 255;
+    uint16_t drawMa = 0;
+    LedPowerModel stripModel[2] = {LED_POWER_MODEL_WS2812B, LED_POWER_MODEL_WS2812B};
+
+    LedTransport *transport = nullptr;
+    FrameProfiler *profiler = nullptr;
+
+    volatile uint32_t shownCount = 0;
+    volatile uint32_t showUs = 0;
+    uint32_t ditherCycles = 0, showCycles = 0; // of the last frame sent
+    bool timingsPending = false;
+    uint32_t waitUs = 0;
+
+    bool diffEnabled = true;
+    bool haveSent = false;
+    uint32_t keepAliveMs = LED_KEEPALIVE_MS;
+    uint32_t lastSig = 0;
+    uint32_t lastSentMs = 0;
+    uint32_t skippedCount = 0;
+
+    uint16_t limitPower(uint64_t variableUa, uint32_t idleUa);
+    void scaleOut(const CRGB *src, CRGB *dst, uint8_t *res, uint16_t n, uint16_t bright16);
+    void showFrame(uint8_t idx);
+    void recordShowTimings();
+
+#if defined(ESP32)
+    TaskHandle_t showTask = nullptr;
+    SemaphoreHandle_t showDone = nullptr;
+
+    static void showTaskEntry(void *arg);
+    void showLoop();
+#endif
 };
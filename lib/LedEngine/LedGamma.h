@@ -0,0 +1,7 @@
+#pragma once
+#include <stdint.h>
+
+// Perceptual 0-255 level -> linear 16-bit output scale (gamma 2.2).
+// The low end keeps sub-8-bit steps, which temporal dithering turns
+// into real output levels.
+extern const uint16_t LED_GAMMA16[256];
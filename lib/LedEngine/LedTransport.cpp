@@ -0,0 +1,27 @@
+#include "LedTransport.h"
+
+#if defined(ESP32)
+
+void FastLEDTransport::begin(CRGB *mainLeds, uint16_t mainCount,
+                             CRGB *detailLeds, uint16_t detailCount)
+{
+    nMain = mainCount;
+    nDetail = detailCount;
+
+    // Use compile-time #defines from LedTransport.h
+    mainCtl = &FastLED.addLeds<WS2812B, LED_PIN_MAIN, LED_TYPE_MAIN>(mainLeds, nMain);
+    detailCtl = &FastLED.addLeds<WS2812B, LED_PIN_DETAIL, LED_TYPE_DETAIL>(detailLeds, nDetail);
+
+    // LedEngine hands over brightness-scaled, dithered frames
+    FastLED.setDither(DISABLE_DITHER);
+}
+
+void FastLEDTransport::show(CRGB *mainLeds, CRGB *detailLeds, uint8_t brightness)
+{
+    // Point the controllers at the buffer being presented (no copy)
+    mainCtl->setLeds(mainLeds, nMain);
+    detailCtl->setLeds(detailLeds, nDetail);
+    FastLED.show(brightness);
+}
+
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+#include <FastLED.h>
+
+#define LED_PIN_MAIN 27
+#define LED_PIN_DETAIL 26
+#define LED_TYPE_MAIN BRG
+#define LED_TYPE_DETAIL GRB
+
+// Pushes a finished frame out to the strips.
+// LedEngine owns the buffers; a transport only reads them. Frames arrive
+// already brightness-scaled and dithered, so brightness is normally 255.
+class LedTransport
+{
+public:
+    virtual ~LedTransport() {}
+    virtual void begin(CRGB *mainLeds, uint16_t mainCount,
+                       CRGB *detailLeds, uint16_t detailCount) = 0;
+    virtual void show(CRGB *mainLeds, CRGB *detailLeds, uint8_t brightness) = 0;
+};
+
+// WS2812B output through FastLED (RMT on ESP32)
+class FastLEDTransport : public LedTransport
+{
+public:
+    void begin(CRGB *mainLeds, uint16_t mainCount,
+               CRGB *detailLeds, uint16_t detailCount) override;
+    void show(CRGB *mainLeds, CRGB *detailLeds, uint8_t brightness) override;
+
+private:
+    CLEDController *mainCtl = nullptr;
+    CLEDController *detailCtl = nullptr;
+    uint16_t nMain = 0, nDetail = 0;
+};
+
+// Host-side stand-in: records what would have been sent
+class MockLedTransport : public LedTransport
+{
+public:
+    void begin(CRGB *, uint16_t mainCount, CRGB *, uint16_t detailCount) override
+    {
+        nMain = mainCount;
+        nDetail = detailCount;
+    }
+
+    void show(CRGB *mainLeds, CRGB *detailLeds, uint8_t brightness) override
+    {
+        lastMain = mainLeds;
+        lastDetail = detailLeds;
+        lastBrightness = brightness;
+        frames++;
+    }
+
+    uint16_t nMain = 0, nDetail = 0;
+    const CRGB *lastMain = nullptr;
+    const CRGB *lastDetail = nullptr;
+    uint8_t lastBrightness = 0;
+    uint32_t frames = 0;
+};
@@ -0,0 +1,159 @@
+#include "Compositor.h"
+
+void Compositor::begin(uint16_t mainCount, uint16_t detailCount)
+{
+    scratchMain.resize(mainCount);
+    scratchDetail.resize(detailCount);
+}
+
+uint8_t Compositor::add(Effect *fx, BlendMode mode, uint8_t opacity, bool covers)
+{
+    Layer l;
+    l.fx = fx;
+    l.mode = mode;
+    l.opacity = opacity;
+    l.covers = covers;
+    layers.push_back(l);
+    return layers.size() - 1;
+}
+
+void Compositor::setEnabled(uint8_t idx, bool on)
+{
+    if (idx < layers.size())
+        layers[idx].enabled = on;
+}
+
+void Compositor::setOpacity(uint8_t idx, uint8_t opacity)
+{
+    if (idx < layers.size())
+        layers[idx].opacity = opacity;
+}
+
+void Compositor::setBlend(uint8_t idx, BlendMode mode)
+{
+    if (idx < layers.size())
+        layers[idx].mode = mode;
+}
+
+void Compositor::setProfileSlot(uint8_t idx, int8_t slot)
+{
+    if (idx < layers.size())
+        layers[idx].profileSlot = slot;
+}
+
+void Compositor::render(const LightingParams &p, const SpatialMap &s,
+                        CRGB *mainLeds, uint16_t nMain,
+                        CRGB *detailLeds, uint16_t nDetail,
+                        uint32_t nowMs, float dt)
+{
+    // Lowest layer that is visible at all: the topmost opaque one hides the rest
+    int16_t base = 0;
+    for (int16_t i = (int16_t)layers.size() - 1; i >= 0; i--)
+    {
+        if (layers[i].enabled && isOpaque(layers[i]))
+        {
+            base = i;
+            break;
+        }
+    }
+    for (int16_t i = 0; i < base; i++)
+        if (layers[i].enabled)
+            culledCount++;
+
+    renderedLast = 0;
+    bool haveBase = false;
+    uint16_t nm = nMain < scratchMain.size() ? nMain : scratchMain.size();
+    uint16_t nd = nDetail < scratchDetail.size() ? nDetail : scratchDetail.size();
+
+    for (uint16_t i = base; i < layers.size(); i++)
+    {
+        const Layer &l = layers[i];
+        if (!l.enabled || !l.fx || (l.opacity == 0 && l.mode != BlendMode::Replace))
+            continue;
+
+        // The bottom layer draws straight into the frame when it overwrites it anyway
+        if (!haveBase && isOpaque(l))
+        {
+            renderLayer(l, p, s, mainLeds, nMain, detailLeds, nDetail, nowMs, dt);
+            haveBase = true;
+            renderedLast++;
+            continue;
+        }
+        if (!haveBase)
+        {
+            fill_solid(mainLeds, nMain, CRGB::Black);
+            fill_solid(detailLeds, nDetail, CRGB::Black);
+            haveBase = true;
+        }
+
+        // Overlays render into scratch, which they may only partly overwrite
+        fill_solid(scratchMain.data(), nm, CRGB::Black);
+        fill_solid(scratchDetail.data(), nd, CRGB::Black);
+        renderLayer(l, p, s, scratchMain.data(), nm, scratchDetail.data(), nd, nowMs, dt);
+        renderedLast++;
+
+        ProfileScope scope(profiler, ProfileStage::Blend);
+        blendInto(mainLeds, scratchMain.data(), nm, l);
+        blendInto(detailLeds, scratchDetail.data(), nd, l);
+    }
+
+    if (!haveBase)
+    {
+        fill_solid(mainLeds, nMain, CRGB::Black);
+        fill_solid(detailLeds, nDetail, CRGB::Black);
+    }
+}
+
+void Compositor::renderLayer(const Layer &l, const LightingParams &p, const SpatialMap &s,
+                             CRGB *mainLeds, uint16_t nMain,
+                             CRGB *detailLeds, uint16_t nDetail,
+                             uint32_t nowMs, float dt)
+{
+    uint32_t start = FrameProfiler::cycles();
+    l.fx->prepareIfChanged(p);
+    l.fx->render(p, s, mainLeds, nMain, detailLeds, nDetail, nowMs, dt);
+    if (profiler && l.profileSlot >= 0)
+        profiler->recordEffect(l.profileSlot, FrameProfiler::cycles() - start);
+}
+
+// Pixels a non-covering layer left black are treated as transparent
+void Compositor::blendInto(CRGB *dst, const CRGB *src, uint16_t n, const Layer &l)
+{
+    const uint8_t opacity = l.opacity;
+    const bool skipBlack = !l.covers;
+
+    switch (l.mode)
+    {
+    case BlendMode::Replace:
+        for (uint16_t i = 0; i < n; i++)
+            if (!skipBlack || src[i])
+                dst[i] = src[i];
+        break;
+
+    case BlendMode::Add:
+        for (uint16_t i = 0; i < n; i++)
+        {
+            CRGB c = src[i];
+            if (opacity != 255)
+                c.nscale8(opacity);
+            dst[i] += c;
+        }
+        break;
+
+    case BlendMode::Multiply:
+        for (uint16_t i = 0; i < n; i++)
+        {
+            if (skipBlack && !src[i])
+                continue;
+            CRGB m(scale8(dst[i].r, src[i].r), scale8(dst[i].g, src[i].g), scale8(dst[i].b, src[i].b));
+            nblend(dst[i], m, opacity);
+        }
+        break;
+
+    case BlendMode::Alpha:
+        for (uint16_t i = 0; i < n; i++)
+            if (!skipBlack || src[i])
+                nblend(dst[i], src[i], opacity);
+        break;
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <FastLED.h>
+#include <vector>
+#include "Effect.h"
+#include "FrameProfiler.h"
+
+// How a layer is combined with what is already below it
+enum class BlendMode : uint8_t
+{
+    Replace = 0, // src (opacity ignored)
+    Add,         // dst + src * opacity, saturating
+    Multiply,    // dst * src, mixed in by opacity
+    Alpha        // dst -> src by opacity
+};
+
+// Ordered stack of effects, bottom layer first.
+// Layers hidden under an enabled, fully opaque layer that covers every
+// pixel are not rendered at all.
+class Compositor
+{
+public:
+    struct Layer
+    {
+        Effect *fx = nullptr;
+        BlendMode mode = BlendMode::Replace;
+        uint8_t opacity = 255;
+        bool covers = true;      // fx writes every pixel on every frame
+        bool enabled = false;
+        int8_t profileSlot = -1; // FrameProfiler effect slot (-1 = not recorded)
+    };
+
+    // Allocates the overlay scratch buffers
+    void begin(uint16_t mainCount, uint16_t detailCount);
+    void setProfiler(FrameProfiler *p) { profiler = p; }
+
+    // Returns the new layer's index (added on top, starts disabled)
+    uint8_t add(Effect *fx, BlendMode mode = BlendMode::Replace,
+                uint8_t opacity = 255, bool covers = true);
+
+    void setEnabled(uint8_t layer, bool on);
+    void setOpacity(uint8_t layer, uint8_t opacity);
+    void setBlend(uint8_t layer, BlendMode mode);
+    void setProfileSlot(uint8_t layer, int8_t slot);
+    const Layer &layer(uint8_t idx) const { return layers[idx]; }
+    uint8_t count() const { return layers.size(); }
+
+    void render(const LightingParams &p, const SpatialMap &s,
+                CRGB *mainLeds, uint16_t mainCount,
+                CRGB *detailLeds, uint16_t detailCount,
+                uint32_t nowMs, float dt);
+
+    // Stats
+    uint8_t lastLayersRendered() const { return renderedLast; }
+    uint32_t layersCulled() const { return culledCount; }
+
+private:
+    std::vector<Layer> layers;
+    std::vector<CRGB> scratchMain;
+    std::vector<CRGB> scratchDetail;
+    FrameProfiler *profiler = nullptr;
+
+    uint8_t renderedLast = 0;
+    uint32_t culledCount = 0;
+
+    static bool isOpaque(const Layer &l)
+    {
+        return l.covers && (l.mode == BlendMode::Replace ||
+                            (l.mode == BlendMode::Alpha && l.opacity == 255));
+    }
+
+    void renderLayer(const Layer &l, const LightingParams &p, const SpatialMap &s,
+                     CRGB *mainLeds, uint16_t mainCount,
+                     CRGB *detailLeds, uint16_t detailCount,
+                     uint32_t nowMs, float dt);
+    static void blendInto(CRGB *dst, const CRGB *src, uint16_t n, const Layer &l);
+};
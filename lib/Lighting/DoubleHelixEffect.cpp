@@ -1,87 +1,79 @@
 #include "DoubleHelixEffect.h"
+#include "FixedMath.h"
 #include <FastLED.h>
 #include <math.h>
 
-void DoubleHelixEffect::render(const LightingParams &P,
-                               const SpatialMap &M,
-                               CRGB *mainLeds, uint16_t nMain,
-                               CRGB *detailLeds, uint16_t nDetail,
-                               uint32_t now)
+void DoubleHelixEffect::buildBaseTurns(const SpatialMap &M, uint16_t nDetail)
 {
-    // Calculate delta time for smooth animation without jumping
-    if (lastUpdate == 0)
-        lastUpdate = now;
-
-    float deltaTime = (now - lastUpdate) / 1000.0f; // Convert to seconds
-    lastUpdate = now;
-
-    // Speed: map from 0-255 to a reasonable animation speed
-    // Minimum speed of 0.1x, maximum of 5x
-    float speedFactor = 0.1f + (P.speed() / 255.0f) * 4.9f;
-
-    // Accumulate phase based on speed - this prevents jumping when speed changes
-    // Doubled speed multiplier (4.0f instead of 2.0f)
-    phase += deltaTime * speedFactor * 4.0f;
+    baseTurns.resize(nDetail);
+    for (uint16_t i = 0; i < nDetail; i++)
+    {
+        float rad = M.angle(i) * 2.0f + M.pos(i).z * 0.12f;
+        baseTurns[i] = (uint16_t)(int32_t)lroundf(rad * FX_TURNS_PER_RAD);
+    }
+    baseMap = &M;
+}
 
-    // Keep phase in reasonable range to avoid float precision issues
-    if (phase > TWO_PI * 100.0f)
-        phase -= TWO_PI * 100.0f;
+// Blend ratio 0..255 from a Q15 wave; invBw = 127.5 / blendWidth
+static inline uint8_t helixRatio(int16_t wave, int32_t invBw)
+{
+    int32_t r = 128 + ((wave * invBw) >> 15);
+    if (r < 0)
+        return 0;
+    if (r > 255)
+        return 255;
+    return (uint8_t)r;
+}
 
+void DoubleHelixEffect::prepare(const LightingParams &P)
+{
     // Intensity controls the interpolation zone width (inverted)
     // High intensity (255) = sharp transition (small blend zone = 0.01)
     // Low intensity (0) = wide blend zone (large blend = 1.0)
     float blendWidth = 1.0f - (P.intensity() / 255.0f);
     // Ensure minimum blend width for visibility
     blendWidth = blendWidth * 0.99f + 0.01f;
+    sharp = blendWidth < 0.02f;
+    invBw = (int32_t)(127.5f / blendWidth);
+}
+
+void DoubleHelixEffect::render(const LightingParams &P,
+                               const SpatialMap &M,
+                               CRGB *mainLeds, uint16_t nMain,
+                               CRGB *detailLeds, uint16_t nDetail,
+                               uint32_t now, float dt)
+{
+    if (baseMap != &M || baseTurns.size() != nDetail)
+        buildBaseTurns(M, nDetail);
 
-    CRGB pri = CHSV(P.mainHue(), P.mainSat(), 255);
-    CRGB sec = CHSV(P.secondaryHue(), P.secondarySat(), 255);
+    // The helix turns once per beat
+    uint16_t phaseTurns = P.beat.phase(256);
 
-    // When secondary is disabled, use black instead of main color
-    if (!P.secondaryEnabled())
-        sec = CRGB::Black;
+    // Gradient runs main (0) -> secondary (255); with secondary disabled it
+    // ends in black instead
+    const ConfigPalette &pal = P.palette();
+    const CRGB &pri = pal[0];
+    const CRGB &sec = pal[255];
 
     // ---- MAIN ELEMENT (2 LEDs) ----
     for (int i = 0; i < nMain; i++)
     {
-        Vec3 p = M.pos(i);
-        float ang = atan2f(p.y, p.x);
-        float wave = sinf(ang * 2.0f + phase); // -1.0 to 1.0
+        int16_t wave = fxSin(M.angleTurns(i) * 2 + phaseTurns); // Q15
 
-        if (blendWidth < 0.02f)
-        {
-            // Sharp transition when intensity is very high
+        if (sharp)
             mainLeds[i] = (wave > 0) ? pri : sec;
-        }
         else
-        {
-            // Smooth blend based on intensity (inverted)
-            // Map wave from [-1, 1] to blend ratio [0, 1]
-            float blendRatio = (wave / blendWidth) * 0.5f + 0.5f;
-            blendRatio = constrain(blendRatio, 0.0f, 1.0f);
-            mainLeds[i] = blend(sec, pri, blendRatio * 255);
-        }
+            mainLeds[i] = pal[255 - helixRatio(wave, invBw)];
     }
 
     // ---- DETAIL STRIP (3D double helix) ----
     for (int i = 0; i < nDetail; i++)
     {
-        Vec3 p = M.pos(i);
-        float ang = atan2f(p.y, p.x);
-        float wave = sinf(ang * 2.0f + p.z * 0.12f + phase); // -1.0 to 1.0
+        int16_t wave = fxSin(baseTurns[i] + phaseTurns); // Q15
 
-        if (blendWidth < 0.02f)
-        {
-            // Sharp transition when intensity is very high
+        if (sharp)
             detailLeds[i] = (wave > 0) ? pri : sec;
-        }
         else
-        {
-            // Smooth blend based on intensity (inverted)
-            // Map wave from [-1, 1] to blend ratio [0, 1]
-            float blendRatio = (wave / blendWidth) * 0.5f + 0.5f;
-            blendRatio = constrain(blendRatio, 0.0f, 1.0f);
-            detailLeds[i] = blend(sec, pri, blendRatio * 255);
-        }
+            detailLeds[i] = pal[255 - helixRatio(wave, invBw)];
     }
 }
@@ -1,18 +1,26 @@
 #pragma once
 #include "Effect.h"
+#include <vector>
 
 class DoubleHelixEffect : public Effect
 {
 public:
     const char *name() const { return "DoubleHelix"; }
 
+    void prepare(const LightingParams &P) override;
     void render(const LightingParams &P,
                 const SpatialMap &M,
                 CRGB *mainLeds, uint16_t nMain,
                 CRGB *detailLeds, uint16_t nDetail,
-                uint32_t nowMs) override;
+                uint32_t nowMs, float dt) override;
 
 private:
-    float phase = 0.0f;      // Accumulated phase to prevent jumping
-    uint32_t lastUpdate = 0; // Last update time for delta calculation
+    // From prepare()
+    bool sharp = false;
+    int32_t invBw = 128;
+
+    // Per-LED 2*angle + 0.12*z in turn units; depends only on the map
+    std::vector<uint16_t> baseTurns;
+    const SpatialMap *baseMap = nullptr;
+    void buildBaseTurns(const SpatialMap &M, uint16_t nDetail);
 };
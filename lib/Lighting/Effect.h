@@ -8,11 +8,40 @@ class Effect
 public:
     virtual ~Effect() {}
     virtual void begin() {}
+
+    // Derive per-config constants (rates, widths, colours). Called before
+    // render() only when the active config, its generation or the mode
+    // changed, so render() is left with the time-dependent work.
+    virtual void prepare(const LightingParams &p) {}
+
     virtual void render(const LightingParams &p,
                         const SpatialMap &s,
                         CRGB *mainLeds,
                         uint16_t mainCount,
                         CRGB *detailLeds,
                         uint16_t detailCount,
-                        uint32_t nowMs) = 0;
+                        uint32_t nowMs,
+                        float dt) = 0; // dt = seconds since the previous frame
+
+    // Run by whoever calls render(), right before it
+    void prepareIfChanged(const LightingParams &p)
+    {
+        if (prepared && preparedCfg == p.activeConfig &&
+            preparedGen == p.activeConfig->generation && preparedMode == p.activeMode)
+            return;
+        prepared = true;
+        preparedCfg = p.activeConfig;
+        preparedGen = p.activeConfig->generation;
+        preparedMode = p.activeMode;
+        prepare(p);
+    }
+
+    // Force prepare() on the next frame
+    void invalidate() { prepared = false; }
+
+private:
+    bool prepared = false;
+    const EffectConfig *preparedCfg = nullptr;
+    uint32_t preparedGen = 0;
+    ConfigMode preparedMode = ConfigMode::Default;
 };
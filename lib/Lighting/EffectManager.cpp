@@ -1,17 +1,30 @@
 #include "EffectManager.h"
 #include <Arduino.h>
 
+void EffectManager::begin(uint16_t mainCount, uint16_t detailCount)
+{
+    scratchMain.resize(mainCount);
+    scratchDetail.resize(detailCount);
+}
+
 void EffectManager::add(Effect *fx, const char *name)
 {
     effects.push_back(fx);
     names.push_back(name);
 }
 
-bool EffectManager::setEffect(uint8_t id)
+bool EffectManager::setEffect(uint8_t id, bool cut)
 {
-    if (id < effects.size() && current != id)
+    if (id >= effects.size())
+        return false;
+    if (cut)
+        outgoing = -1;
+    if (current != id)
     {
-        current = id;
+        if (cut)
+            current = id;
+        else
+            switchTo(id);
         return true; // changed
     }
     return false;
@@ -22,7 +35,7 @@ bool EffectManager::next()
     uint8_t newID = (current + 1) % effects.size();
     if (newID != current)
     {
-        current = newID;
+        switchTo(newID);
         return true;
     }
     return false;
@@ -38,18 +51,64 @@ Effect *EffectManager::active()
     return effects.empty() ? nullptr : effects[current];
 }
 
+void EffectManager::switchTo(uint8_t id)
+{
+    // Nothing on screen yet (boot effect) or no scratch: cut straight over.
+    // Switching again mid-fade fades out from the effect that was coming in.
+    if (crossfadeMs && hasRendered && !scratchDetail.empty())
+    {
+        outgoing = current;
+        fadeStarted = false; // clock starts on the next render
+    }
+    current = id;
+}
+
 const char *EffectManager::activeName() const
 {
     return effects.empty() ? "None" : names[current];
 }
 
+const char *EffectManager::nameOf(uint8_t id) const
+{
+    return id < names.size() ? names[id] : "None";
+}
+
 void EffectManager::render(const LightingParams &p,
                            const SpatialMap &s,
                            CRGB *mainLeds, uint16_t nMain,
                            CRGB *detailLeds, uint16_t nDetail,
-                           uint32_t nowMs)
+                           uint32_t nowMs, float dt)
 {
     if (!active())
         return;
-    effects[current]->render(p, s, mainLeds, nMain, detailLeds, nDetail, nowMs);
+    hasRendered = true;
+    effects[current]->prepareIfChanged(p);
+    effects[current]->render(p, s, mainLeds, nMain, detailLeds, nDetail, nowMs, dt);
+
+    if (outgoing < 0)
+        return;
+
+    if (!fadeStarted)
+    {
+        fadeStartMs = nowMs;
+        fadeStarted = true;
+    }
+    uint32_t elapsed = nowMs - fadeStartMs;
+    if (elapsed >= crossfadeMs || outgoing == current)
+    {
+        outgoing = -1;
+        return;
+    }
+
+    uint16_t nm = nMain < scratchMain.size() ? nMain : scratchMain.size();
+    uint16_t nd = nDetail < scratchDetail.size() ? nDetail : scratchDetail.size();
+    effects[outgoing]->prepareIfChanged(p);
+    effects[outgoing]->render(p, s, scratchMain.data(), nm, scratchDetail.data(), nd, nowMs, dt);
+
+    // Share of the outgoing frame still showing
+    uint8_t amountOld = 255 - (uint8_t)((elapsed * 255) / crossfadeMs);
+    for (uint16_t i = 0; i < nm; i++)
+        nblend(mainLeds[i], scratchMain[i], amountOld);
+    for (uint16_t i = 0; i < nd; i++)
+        nblend(detailLeds[i], scratchDetail[i], amountOld);
 }
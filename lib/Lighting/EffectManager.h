@@ -2,15 +2,26 @@
 #include "Effect.h"
 #include <vector>
 
-class EffectManager
+#define EFFECT_CROSSFADE_MS 400
+
+// Also an Effect, so the active effect can sit in a Compositor layer
+class EffectManager : public Effect
 {
 public:
+    // Allocates the crossfade scratch buffers; without it switches cut hard
+    void begin(uint16_t mainCount, uint16_t detailCount);
+    void setCrossfadeMs(uint16_t ms) { crossfadeMs = ms; } // 0 = hard cut
+
     void add(Effect *fx, const char *name);
-    bool setEffect(uint8_t id);
+    // Switches with a crossfade; cut = true switches on the next frame and
+    // drops a fade in progress (scene recall)
+    bool setEffect(uint8_t id, bool cut = false);
     bool next();
     uint8_t count() const;
     Effect *active();
     const char *activeName() const;
+    const char *nameOf(uint8_t id) const;
+    bool fading() const { return outgoing >= 0; }
 
     void render(const LightingParams &params,
                 const SpatialMap &map,
@@ -18,10 +29,23 @@ public:
                 uint16_t mainCount,
                 CRGB *detailLeds,
                 uint16_t detailCount,
-                uint32_t nowMs);
+                uint32_t nowMs,
+                float dt) override;
 
 private:
     std::vector<Effect *> effects;
     std::vector<const char *> names;
     uint8_t current = 0;
+
+    // Crossfade: the outgoing effect renders into scratch and is mixed
+    // out over crossfadeMs, then dropped
+    std::vector<CRGB> scratchMain;
+    std::vector<CRGB> scratchDetail;
+    uint16_t crossfadeMs = EFFECT_CROSSFADE_MS;
+    int16_t outgoing = -1;
+    bool fadeStarted = false;
+    bool hasRendered = false;
+    uint32_t fadeStartMs = 0;
+
+    void switchTo(uint8_t id);
 };
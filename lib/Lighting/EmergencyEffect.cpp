@@ -4,25 +4,25 @@
 void EmergencyEffect::render(const LightingParams &P, const SpatialMap &map,
                              CRGB *mainLeds, uint16_t mainCount,
                              CRGB *detailLeds, uint16_t detailCount,
-                             uint32_t now)
+                             uint32_t now, float dt)
 {
     // Speed controls rotation rate and fade speed
     // Minimum speed of 20% so it always moves
     float speedFactor = 0.2f + (P.activeConfig->speed / 100.0f) * 0.8f;
 
     // Update rotation angle for detail LEDs (doubled speed)
-    angle += speedFactor * 0.06f;
+    // 3.6 rad/s = the original 0.06 rad per frame at 60 fps
+    angle += speedFactor * 3.6f * dt;
     if (angle > TWO_PI)
         angle -= TWO_PI;
 
     // Render detail LEDs: rotating blue/red split per string with linear fade
-    const uint8_t numStrings = map.segments() * 2;          // 16 strings (2 per segment)
-    const uint8_t ledsPerString = detailCount / numStrings; // 15 LEDs per string
+    const uint8_t numStrings = map.stringCount(); // 16 strings (2 per segment)
 
     for (uint16_t i = 0; i < detailCount; i++)
     {
         // Determine which string this LED belongs to
-        uint8_t stringIndex = i / ledsPerString;
+        uint8_t stringIndex = map.stringOf(i);
 
         // Calculate the angular position of this string (0 to TWO_PI)
         // Strings are arranged in a circle: 0 = front, increasing clockwise
@@ -69,24 +69,24 @@ void EmergencyEffect::render(const LightingParams &P, const SpatialMap &map,
     }
 
     // Main LEDs: smooth fade between blue and red
-    // Update fade value based on speed (always at least 1 step)
-    int fadeStep = max(1, (int)(speedFactor * 2.0f));
+    // Update fade value based on speed (at least 60 steps/s, i.e. 1 step per frame at 60 fps)
+    float fadeStep = max(60.0f, speedFactor * 120.0f) * dt;
 
     if (fadeDirection)
     {
         mainFade += fadeStep;
-        if (mainFade >= 255)
+        if (mainFade >= 255.0f)
         {
-            mainFade = 255;
+            mainFade = 255.0f;
             fadeDirection = false;
         }
     }
     else
     {
         mainFade -= fadeStep;
-        if (mainFade <= 0)
+        if (mainFade <= 0.0f)
         {
-            mainFade = 0;
+            mainFade = 0.0f;
             fadeDirection = true;
         }
     }
@@ -97,6 +97,6 @@ void EmergencyEffect::render(const LightingParams &P, const SpatialMap &map,
 
     for (uint16_t i = 0; i < mainCount; i++)
     {
-        mainLeds[i] = blend(blue, red, mainFade);
+        mainLeds[i] = blend(blue, red, (uint8_t)mainFade);
     }
 }
@@ -2,6 +2,7 @@
 #include "Effect.h"
 #include "SpatialMap.h"
 #include "EffectConfig.h"
+#include "ParticleSystem.h"
 
 class EnergyBurstEffect : public Effect
 {
@@ -9,9 +10,10 @@ public:
     void render(const LightingParams &P, const SpatialMap &map,
                 CRGB *mainLeds, uint16_t mainCount,
                 CRGB *detailLeds, uint16_t detailCount,
-                uint32_t now) override;
+                uint32_t now, float dt) override;
 
-    void setState(EnergyBurstState state);
+    // nowMs = frame time; the explosion animates from it
+    void setState(EnergyBurstState state, uint32_t nowMs);
     EnergyBurstState getState() const { return state; }
 
     void reset();
@@ -34,6 +36,9 @@ public:
 
     float getExplosionHeightThreshold() const { return explosionHeightThreshold; }
 
+    // Droplet pool size; takes effect on the next render (droplets are cleared)
+    void setMaxDroplets(uint16_t n) { maxDroplets = n; }
+
 private:
     EnergyBurstState state = EnergyBurstState::Inactive;
     uint32_t explosionStartTime = 0;
@@ -46,15 +51,13 @@ private:
     // Explosion height threshold (0.0 = bottom, 1.0 = top)
     float explosionHeightThreshold = 0.2f;
 
-    // Droplet tracking
-    struct Droplet
-    {
-        uint16_t startLED; // LED index where droplet started
-        float progress;    // 0.0 to 1.0, how far down the droplet has fallen
-        bool active;
-    };
-    static const uint8_t MAX_DROPLETS = 32; // Enough for multiple rotations
-    Droplet droplets[MAX_DROPLETS];
+    // Droplet particles: pos = fall progress (Q16, 65536 = bottom),
+    // aux = start height (Q16)
+    static const uint16_t MAX_DROPLETS = 32; // Enough for multiple rotations
+    ParticleSystem droplets;
+    DrawList drawn;
+    uint16_t maxDroplets = MAX_DROPLETS;
+    int32_t lastDropletVel = 0;
 
     static const uint32_t EXPLOSION_DURATION = 2000; // 2 seconds
 };
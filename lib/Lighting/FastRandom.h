@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+
+// xorshift32: a few cycles per number, seedable so runs can be replayed.
+// Not for anything that needs statistical quality beyond visuals.
+class FastRandom
+{
+public:
+    explicit FastRandom(uint32_t seed = 0x9E3779B9u) { setSeed(seed); }
+
+    void setSeed(uint32_t seed) { state = seed ? seed : 0x9E3779B9u; }
+
+    uint32_t next()
+    {
+        uint32_t x = state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return state = x;
+    }
+
+    // 0 .. n-1 (multiply-shift, no division)
+    uint16_t below(uint16_t n) { return (uint16_t)(((next() >> 16) * n) >> 16); }
+
+    // true with probability pct/100
+    bool chance(uint8_t pct) { return below(100) < pct; }
+
+private:
+    uint32_t state;
+};
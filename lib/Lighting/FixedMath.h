@@ -0,0 +1,122 @@
+#pragma once
+#include <stdint.h>
+
+// Fixed-point math kernels for per-LED render loops.
+//
+// Angles are uint16_t "turns": 65536 = one full circle (2*PI), so angle
+// arithmetic wraps for free. Sine results are Q15 (-32767..32767).
+//
+// Error bounds (checked by the host benchmark, src/bench; it fails when
+// one is exceeded):
+//   fxSin/fxCos : |err| <= 4 LSB Q15 (~1.2e-4)
+//   fxAtan2     : |err| <= 20 turn units (~0.11 deg)
+//   fxSqrt*     : exact floor of the true root
+#define FX_SIN_MAX_ERR_LSB 4.0
+#define FX_ATAN2_MAX_ERR_TURNS 20.0
+
+// Radians -> turn units
+#define FX_TURNS_PER_RAD 10430.378f
+
+extern const int16_t FX_SIN_LUT[256];
+
+// Q15 sine of a turn angle: 256-entry table + linear interpolation
+inline int16_t fxSin(uint16_t angle)
+{
+    uint8_t idx = angle >> 8;
+    int32_t frac = angle & 0xFF;
+    int32_t s0 = FX_SIN_LUT[idx];
+    int32_t s1 = FX_SIN_LUT[(uint8_t)(idx + 1)];
+    return (int16_t)(s0 + (((s1 - s0) * frac) >> 8));
+}
+
+inline int16_t fxCos(uint16_t angle)
+{
+    return fxSin(angle + 16384);
+}
+
+// Sine mapped to 0..255 (0.5 + 0.5*sin), the usual brightness wave
+inline uint8_t fxSin8(uint16_t angle)
+{
+    return (uint8_t)((fxSin(angle) + 32768) >> 8);
+}
+
+// Angle of (x, y) in turn units, 0 = +x axis, counter-clockwise.
+// Octant reduction + polynomial atan on [0, 1].
+inline uint16_t fxAtan2(int32_t y, int32_t x)
+{
+    if (x == 0 && y == 0)
+        return 0;
+
+    uint32_t ax = x < 0 ? -(int64_t)x : x;
+    uint32_t ay = y < 0 ? -(int64_t)y : y;
+
+    // z = min/max in Q15
+    bool steep = ay > ax;
+    int32_t z = steep ? (int32_t)(((uint64_t)ax << 15) / ay)
+                      : (int32_t)(((uint64_t)ay << 15) / ax);
+
+    // atan(z) ~= PI/4*z + z*(1-z)*(0.2447 + 0.0663*z)   (radians, max err 0.0015)
+    int32_t zz = (z * (32768 - z)) >> 15;
+    int32_t coef = 8018 + ((2172 * z) >> 15);
+    int32_t corr = (zz * coef) >> 15;
+    int32_t a = (z >> 2) + ((corr * 10430) >> 15);
+
+    if (steep)
+        a = 16384 - a;
+    if (x < 0)
+        a = 32768 - a;
+    if (y < 0)
+        a = -a;
+    return (uint16_t)a;
+}
+
+// Integer square root: floor(sqrt(v))
+inline uint32_t fxSqrt64(uint64_t v)
+{
+    uint64_t res = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v)
+        bit >>= 2;
+    while (bit)
+    {
+        if (v >= res + bit)
+        {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else
+        {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+inline uint16_t fxSqrt32(uint32_t v)
+{
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > v)
+        bit >>= 2;
+    while (bit)
+    {
+        if (v >= res + bit)
+        {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else
+        {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)res;
+}
+
+// Square root of a Q16 value, result in Q16
+inline uint32_t fxSqrtQ16(uint32_t q16)
+{
+    return fxSqrt64((uint64_t)q16 << 16);
+}
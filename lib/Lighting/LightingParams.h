@@ -1,6 +1,9 @@
 #pragma once
 #include <stdint.h>
 #include "EffectConfig.h"
+#include "Palette.h"
+#include "AudioFeatures.h"
+#include "BeatClock.h"
 
 struct LightingParams
 {
@@ -22,6 +25,12 @@ struct LightingParams
     // Explosion timer for Special2
     uint32_t explosionStartTime = 0;
 
+    // Latest audio analysis (bands, onsets, tempo); inactive without a source
+    AudioFeatures audio;
+
+    // Shared tempo and beat position; effects take their motion from it
+    BeatClock beat;
+
     // Legacy accessors for backward compatibility (delegate to activeConfig)
     uint8_t &mainHue() { return activeConfig->mainHue; }
     uint8_t &mainSat() { return activeConfig->mainSat; }
@@ -39,4 +48,14 @@ struct LightingParams
     uint8_t speed() const { return activeConfig->speed; }
     uint8_t intensity() const { return activeConfig->intensity; }
     bool secondaryEnabled() const { return activeConfig->secondaryEnabled; }
+
+    // Colours of the active config (rebuilt lazily when they change)
+    const ConfigPalette &palette() const
+    {
+        pal.update(*activeConfig);
+        return pal;
+    }
+
+private:
+    mutable ConfigPalette pal;
 };
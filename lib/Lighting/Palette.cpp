@@ -0,0 +1,22 @@
+#include "Palette.h"
+#include <string.h>
+
+bool ConfigPalette::update(const EffectConfig &cfg)
+{
+    const uint8_t k[5] = {cfg.mainHue, cfg.mainSat, cfg.secondaryHue, cfg.secondarySat,
+                          (uint8_t)cfg.secondaryEnabled};
+    if (valid && memcmp(k, key, sizeof(key)) == 0)
+        return false;
+
+    memcpy(key, k, sizeof(key));
+    valid = true;
+
+    pri = CHSV(cfg.mainHue, cfg.mainSat, 255);
+    sec = CHSV(cfg.secondaryHue, cfg.secondarySat, 255);
+
+    const CRGB end = cfg.secondaryEnabled ? sec : CRGB(CRGB::Black);
+    for (uint16_t i = 0; i < 255; i++)
+        grad[i] = blend(pri, end, (uint8_t)i);
+    grad[255] = end; // blend() stops one step short
+    return true;
+}
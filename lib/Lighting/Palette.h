@@ -0,0 +1,24 @@
+#pragma once
+#include <FastLED.h>
+#include "EffectConfig.h"
+
+// Full-value colours of one EffectConfig plus a 256-entry gradient from
+// main (0) to secondary (255), or to black while secondary is disabled.
+// Rebuilt only when the config's colour fields change, so per-LED colour
+// is a table read instead of an HSV conversion or blend.
+class ConfigPalette
+{
+public:
+    // Returns true if the palette was rebuilt
+    bool update(const EffectConfig &cfg);
+
+    const CRGB &main() const { return pri; }
+    const CRGB &secondary() const { return sec; } // regardless of secondaryEnabled
+    const CRGB &operator[](uint8_t idx) const { return grad[idx]; }
+
+private:
+    CRGB grad[256];
+    CRGB pri, sec;
+    uint8_t key[5] = {};
+    bool valid = false;
+};
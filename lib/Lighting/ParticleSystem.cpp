@@ -0,0 +1,65 @@
+#include "ParticleSystem.h"
+
+void ParticleSystem::begin(uint16_t cap)
+{
+    pool.assign(cap, Particle());
+    live.clear();
+    live.reserve(cap);
+    freeSlots.resize(cap);
+    for (uint16_t i = 0; i < cap; i++)
+        freeSlots[i] = cap - 1 - i; // pop order 0, 1, 2, ...
+}
+
+ParticleSystem::Particle *ParticleSystem::spawn()
+{
+    if (freeSlots.empty())
+        return nullptr;
+
+    uint16_t slot = freeSlots.back();
+    freeSlots.pop_back();
+    live.push_back(slot);
+    pool[slot] = Particle();
+    return &pool[slot];
+}
+
+void ParticleSystem::killAt(uint16_t k)
+{
+    freeSlots.push_back(live[k]);
+    live[k] = live.back();
+    live.pop_back();
+}
+
+void ParticleSystem::clear()
+{
+    while (!live.empty())
+        killAt(live.size() - 1);
+}
+
+void ParticleSystem::integrate(int32_t dtQ16)
+{
+    for (uint16_t slot : live)
+    {
+        Particle &p = pool[slot];
+        p.pos += (int32_t)(((int64_t)p.vel * dtQ16) >> 16);
+    }
+}
+
+void ParticleSystem::setAllVelocity(int32_t vel)
+{
+    for (uint16_t slot : live)
+        pool[slot].vel = vel;
+}
+
+void DrawList::begin(uint16_t ledCount)
+{
+    mark.assign(ledCount, 0);
+    touched.clear();
+    touched.reserve(ledCount);
+}
+
+void DrawList::reset()
+{
+    for (uint16_t led : touched)
+        mark[led] = 0;
+    touched.clear();
+}
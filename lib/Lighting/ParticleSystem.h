@@ -0,0 +1,83 @@
+#pragma once
+#include <FastLED.h>
+#include <vector>
+#include "SpatialMap.h"
+
+// Pool of particles moving along the SpatialMap strings.
+//
+// spawn() and kill() are O(1): free slots sit on a stack, live ones in a
+// dense list (swap-remove on kill), so updates only touch live particles.
+// Positions are Q16 heights (65536 = top of a string) and may leave 0..1
+// for effects that track particles above or below the strings.
+class ParticleSystem
+{
+public:
+    struct Particle
+    {
+        int32_t pos = 0;    // Q16 height
+        int32_t vel = 0;    // Q16 height per second
+        uint8_t string = 0; // SpatialMap string
+        uint8_t tag = 0;    // effect-defined (colour, phase, ...)
+        uint16_t aux = 0;   // effect-defined
+    };
+
+    void begin(uint16_t capacity);
+    uint16_t capacity() const { return pool.size(); }
+
+    // Returns nullptr when the pool is full
+    Particle *spawn();
+
+    // Live particles, in no particular order. Kill while iterating with
+    // killAt(k) and don't advance k.
+    uint16_t count() const { return live.size(); }
+    Particle &at(uint16_t k) { return pool[live[k]]; }
+    void killAt(uint16_t k);
+    void clear();
+
+    // pos += vel * dt for every live particle (dtQ16 = seconds, Q16)
+    void integrate(int32_t dtQ16);
+    void setAllVelocity(int32_t vel);
+
+    // Nearest LED to a particle on its string
+    static uint16_t ledOf(const Particle &p, const SpatialMap &map)
+    {
+        return map.ledAtHeightQ16(p.string, p.pos);
+    }
+
+    static int32_t toQ16(float v) { return (int32_t)(v * 65536.0f); }
+
+private:
+    std::vector<Particle> pool;
+    std::vector<uint16_t> freeSlots;
+    std::vector<uint16_t> live;
+};
+
+// Pixels written this frame, deduplicated. Effects draw through it so only
+// touched pixels are written, then read back the list (e.g. to skip them
+// when painting a background).
+class DrawList
+{
+public:
+    void begin(uint16_t ledCount);
+    uint16_t ledCount() const { return mark.size(); }
+    void reset();
+
+    // Write c at led; later writes to the same pixel replace it
+    void set(CRGB *leds, uint16_t led, const CRGB &c)
+    {
+        leds[led] = c;
+        if (!mark[led])
+        {
+            mark[led] = 1;
+            touched.push_back(led);
+        }
+    }
+
+    bool has(uint16_t led) const { return mark[led] != 0; }
+    uint16_t count() const { return touched.size(); }
+    uint16_t operator[](uint16_t k) const { return touched[k]; }
+
+private:
+    std::vector<uint8_t> mark;
+    std::vector<uint16_t> touched;
+};
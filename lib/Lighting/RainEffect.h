@@ -2,39 +2,40 @@
 #include "Effect.h"
 #include "SpatialMap.h"
 #include "EffectConfig.h"
-
-// Forward declare BPM range (defined in main.cpp)
-#ifndef MIN_BPM
-#define MIN_BPM 50.0f
-#endif
-#ifndef MAX_BPM
-#define MAX_BPM 180.0f
-#endif
+#include "ParticleSystem.h"
+#include "FastRandom.h"
 
 class RainEffect : public Effect
 {
 public:
+    void prepare(const LightingParams &P) override;
     void render(const LightingParams &P, const SpatialMap &map,
                 CRGB *mainLeds, uint16_t mainCount,
                 CRGB *detailLeds, uint16_t detailCount,
-                uint32_t now) override;
+                uint32_t now, float dt) override;
 
     void reset();
 
+    // Pool size; takes effect on the next render (drops are cleared)
+    void setMaxDrops(uint16_t n) { maxDrops = n; }
+
+    // Drop placement and colour; the same seed and frames give the same rain
+    void seed(uint32_t s) { rng.setSeed(s); }
+
 private:
-    // Raindrop tracking
-    struct Raindrop
-    {
-        uint16_t stringIndex;   // Which string (0 to NUM_STRINGS-1)
-        float height;           // Current normalized height (1.0 = top, 0.0 = bottom)
-        bool useSecondaryColor; // true if this drop uses secondary color
-        bool active;
-        uint8_t mainLedPhase; // 0 = not in main LEDs, 1 = LED 2, 2 = LED 1, 3 = entering strings
-    };
-
-    static const uint8_t MAX_RAINDROPS = 64; // Maximum simultaneous raindrops
-    Raindrop raindrops[MAX_RAINDROPS];
-
-    uint32_t lastSpawnTime = 0;
-    uint32_t lastUpdateTime = 0;
+    // Raindrop particles: pos = height within the current phase (Q16),
+    // tag = DROP_SECONDARY flag, aux = main LED phase
+    // (0 = above main LEDs, 1 = LED 2, 2 = LED 1, 3 = in the strings)
+    static const uint8_t DROP_SECONDARY = 1;
+    static const uint16_t MAX_RAINDROPS = 64; // Default simultaneous raindrops
+
+    ParticleSystem drops;
+    FastRandom rng;
+    uint16_t maxDrops = MAX_RAINDROPS;
+
+    uint32_t lastSpawnSlot = UINT32_MAX;
+    int32_t fallVelQ16 = 0; // Q16 height units per second (negative = down)
+
+    // From prepare()
+    uint32_t spawnsPerBeatQ8 = 256;
 };
@@ -4,7 +4,7 @@ void SolidColorEffect::render(const LightingParams &P,
                               const SpatialMap &map,
                               CRGB *mainLeds, uint16_t nMain,
                               CRGB *detailLeds, uint16_t nDetail,
-                              uint32_t)
+                              uint32_t, float)
 {
     CRGB pri = CHSV(P.mainHue(), P.mainSat(), P.intensity());
     CRGB sec = CHSV(P.secondaryHue(), P.secondarySat(), P.intensity());
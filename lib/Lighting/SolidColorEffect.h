@@ -8,5 +8,5 @@ public:
                 const SpatialMap &,
                 CRGB *mainLeds, uint16_t nMain,
                 CRGB *detailLeds, uint16_t nDetail,
-                uint32_t);
+                uint32_t, float) override;
 };
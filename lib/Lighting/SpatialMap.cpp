@@ -1,4 +1,6 @@
 #include "SpatialMap.h"
+#include "FixedMath.h"
+#include <assert.h>
 
 SpatialMap::SpatialMap(uint16_t leds, uint8_t ledSegments,
                        float radiusCm, float spacingCm,
@@ -10,6 +12,14 @@ SpatialMap::SpatialMap(uint16_t leds, uint8_t ledSegments,
       cw(clockwise)
 {
     coords.resize(totalLEDs);
+    heightNorm.resize(totalLEDs);
+    polarAngle.resize(totalLEDs);
+    centerDist.resize(totalLEDs);
+    ledString.resize(totalLEDs);
+    ledDepth.resize(totalLEDs);
+    angleFx.resize(totalLEDs);
+    zFx.resize(totalLEDs);
+    centerDistFx.resize(totalLEDs);
 }
 
 void SpatialMap::begin()
@@ -50,5 +60,106 @@ void SpatialMap::begin()
         float z = -spacing * depthLevel;
 
         coords[i] = {x, y, z};
+        ledDepth[i] = depthLevel;
+    }
+
+    buildAttributes();
+    buildHeightLookup();
+}
+
+void SpatialMap::buildAttributes()
+{
+    stringLen = totalLEDs / stringCount();
+
+    // Height range and centroid
+    zMin = coords[0].z;
+    zMax = coords[0].z;
+    float cx = 0.0f, cy = 0.0f, cz = 0.0f;
+    for (uint16_t i = 0; i < totalLEDs; ++i)
+    {
+        const Vec3 &p = coords[i];
+        if (p.z < zMin)
+            zMin = p.z;
+        if (p.z > zMax)
+            zMax = p.z;
+        cx += p.x;
+        cy += p.y;
+        cz += p.z;
+    }
+    cx /= totalLEDs;
+    cy /= totalLEDs;
+    cz /= totalLEDs;
+
+    float zRange = zMax - zMin;
+    centerDistMax = 0.0f;
+
+    for (uint16_t i = 0; i < totalLEDs; ++i)
+    {
+        const Vec3 &p = coords[i];
+
+        heightNorm[i] = zRange > 0.0f ? (p.z - zMin) / zRange : 0.0f;
+        polarAngle[i] = atan2f(p.y, p.x);
+
+        float dx = p.x - cx, dy = p.y - cy, dz = p.z - cz;
+        centerDist[i] = sqrtf(dx * dx + dy * dy + dz * dz);
+        if (centerDist[i] > centerDistMax)
+            centerDistMax = centerDist[i];
+
+        uint16_t s = stringLen ? i / stringLen : 0;
+        ledString[i] = s < stringCount() ? s : stringCount() - 1;
+
+        angleFx[i] = (uint16_t)(int32_t)lroundf(polarAngle[i] * FX_TURNS_PER_RAD);
+        assert(fabsf(p.z) <= Q8_MAX_CM && centerDist[i] <= Q8_MAX_CM);
+        zFx[i] = (int32_t)lroundf(p.z * 256.0f);
+        centerDistFx[i] = (uint32_t)lroundf(centerDist[i] * 256.0f);
+    }
+}
+
+void SpatialMap::buildHeightLookup()
+{
+    const uint8_t strings = stringCount();
+    steps = stringLen * 2 > HEIGHT_STEPS_MIN ? stringLen * 2 : HEIGHT_STEPS_MIN;
+    heightLut.assign((size_t)strings * steps, 0);
+    below.assign(totalLEDs, -1);
+
+    for (uint8_t s = 0; s < strings; ++s)
+    {
+        uint16_t start = s * stringLen;
+
+        // Quantised height -> nearest LED (first one wins on ties, like a linear scan)
+        for (uint16_t q = 0; q < steps; ++q)
+        {
+            float h = q / (float)(steps - 1);
+            uint16_t best = 0;
+            float bestDiff = 999999.0f;
+            for (uint16_t k = 0; k < stringLen; ++k)
+            {
+                float diff = fabsf(heightNorm[start + k] - h);
+                if (diff < bestDiff)
+                {
+                    bestDiff = diff;
+                    best = k;
+                }
+            }
+            heightLut[(size_t)s * steps + q] = best;
+        }
+
+        // Highest LED strictly below each LED on the same string
+        for (uint16_t k = 0; k < stringLen; ++k)
+        {
+            float hk = heightNorm[start + k];
+            int16_t bestIdx = -1;
+            float bestH = -1.0f;
+            for (uint16_t j = 0; j < stringLen; ++j)
+            {
+                float hj = heightNorm[start + j];
+                if (hj < hk && hj > bestH)
+                {
+                    bestH = hj;
+                    bestIdx = start + j;
+                }
+            }
+            below[start + k] = bestIdx;
+        }
     }
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <stdint.h>
 #include <vector>
 #include <math.h>
 
@@ -19,6 +20,57 @@ public:
     uint16_t count() const { return totalLEDs; }
     uint8_t segments() const { return ledStringSegments; }
 
+    // Each U-segment is two hanging strings (down half + up half)
+    uint8_t stringCount() const { return ledStringSegments * 2; }
+    uint16_t ledsPerString() const { return stringLen; }
+
+    // Derived per-LED attributes, precomputed in begin()
+    float normHeight(uint16_t i) const { return heightNorm[i]; }    // 0 = lowest LED, 1 = top
+    float angle(uint16_t i) const { return polarAngle[i]; }         // atan2(y, x) in -PI..PI
+    float centroidDist(uint16_t i) const { return centerDist[i]; }  // cm from the LED centroid
+    uint8_t stringOf(uint16_t i) const { return ledString[i]; }   // 0 .. stringCount()-1
+    uint8_t depthOf(uint16_t i) const { return ledDepth[i]; }     // LEDs below hole level
+
+    // Fixed-point copies for integer render loops (see FixedMath.h). The Q8
+    // lengths are 32-bit, so any map up to Q8_MAX_CM keeps full range.
+    static constexpr float Q8_MAX_CM = 8388607.0f; // 2^31 / 256 - 1
+    uint16_t angleTurns(uint16_t i) const { return angleFx[i]; }         // angle() in turn units
+    int32_t zQ8(uint16_t i) const { return zFx[i]; }                     // pos().z in cm, Q8
+    uint32_t centroidDistQ8(uint16_t i) const { return centerDistFx[i]; } // centroidDist() in cm, Q8
+
+    // Nearest LED to a normalised height on one string, O(1) via a quantised
+    // table (covers both halves of each U). The table has at least two
+    // levels per LED on the string, so no LED falls between two levels.
+    static const uint16_t HEIGHT_STEPS_MIN = 64;
+    uint16_t heightSteps() const { return steps; }
+    uint16_t ledAtHeight(uint8_t string, float h) const
+    {
+        if (h < 0.0f)
+            h = 0.0f;
+        else if (h > 1.0f)
+            h = 1.0f;
+        uint16_t q = (uint16_t)(h * (steps - 1) + 0.5f);
+        return string * stringLen + heightLut[string * steps + q];
+    }
+
+    // Same, for a Q16 height (65536 = top), clamped to 0..1
+    uint16_t ledAtHeightQ16(uint8_t string, int32_t h) const
+    {
+        if (h < 0)
+            h = 0;
+        else if (h > 65536)
+            h = 65536;
+        uint16_t q = (uint16_t)(((uint32_t)h * (steps - 1) + 32768) >> 16);
+        return string * stringLen + heightLut[string * steps + q];
+    }
+
+    // Next LED down the same string, or -1 at the bottom
+    int16_t ledBelow(uint16_t i) const { return below[i]; }
+
+    float minZ() const { return zMin; }
+    float maxZ() const { return zMax; }
+    float maxCentroidDist() const { return centerDistMax; }
+
 private:
     uint16_t totalLEDs;
     uint8_t ledStringSegments;
@@ -27,4 +79,25 @@ private:
     bool cw;
 
     std::vector<Vec3> coords;
+
+    // Attribute cache (structure of arrays)
+    uint16_t stringLen = 0;
+    std::vector<float> heightNorm;
+    std::vector<float> polarAngle;
+    std::vector<float> centerDist;
+    std::vector<uint8_t> ledString;
+    std::vector<uint8_t> ledDepth;
+    std::vector<uint16_t> angleFx;
+    std::vector<int32_t> zFx;
+    std::vector<uint32_t> centerDistFx;
+    float zMin = 0.0f, zMax = 0.0f;
+    float centerDistMax = 0.0f;
+
+    // Height lookup: per string, steps offsets into the string
+    uint16_t steps = HEIGHT_STEPS_MIN;
+    std::vector<uint16_t> heightLut;
+    std::vector<int16_t> below;
+
+    void buildAttributes();
+    void buildHeightLookup();
 };
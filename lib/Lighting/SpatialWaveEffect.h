@@ -1,66 +1,54 @@
 #pragma once
 #include "Effect.h"
+#include "FixedMath.h"
 #include <math.h>
 
 class SpatialWaveEffect : public Effect
 {
 private:
-    float phase = 0.0f;
-    uint32_t lastUpdate = 0;
+    // From prepare()
+    int32_t turnsPerCm = 0;
 
 public:
-    void render(const LightingParams &P,
-                const SpatialMap &S,
-                CRGB *mainLeds, uint16_t nMain,
-                CRGB *detailLeds, uint16_t nDetail,
-                uint32_t nowMs) override
+    void prepare(const LightingParams &P) override
     {
-        // Calculate delta time for smooth animation
-        if (lastUpdate == 0)
-            lastUpdate = nowMs;
-
-        float deltaTime = (nowMs - lastUpdate) / 1000.0f;
-        lastUpdate = nowMs;
-
-        // Speed controls animation rate with minimum to ensure always moving
-        // Map speed 0-255 to speed range 0.5x to 10.0x (never stops)
-        float speedNorm = P.speed() / 255.0f;
-        float speedFactor = 0.5f + speedNorm * 9.5f; // Min 0.5x, Max 10.0x
-        phase += deltaTime * speedFactor;
-
-        // Keep phase in reasonable range
-        if (phase > TWO_PI * 100.0f)
-            phase -= TWO_PI * 100.0f;
-
         // Intensity controls wavelength (spatial frequency)
         // Map intensity 0-255 to wavelength 5cm-60cm
-        // Wavelength in cm, need to convert to spatial frequency
+        // Spatial frequency in turns per cm, applied to Q8 heights
         float intensityNorm = P.intensity() / 255.0f;
         float wavelengthCm = 5.0f + intensityNorm * 55.0f; // 5cm to 60cm
-        // Spatial frequency = 2*PI / wavelength (in cm)
-        // v.z is in cm, so frequency directly relates to wavelength
-        float spatialFrequency = (2.0f * PI) / wavelengthCm;
+        turnsPerCm = (int32_t)(65536.0f / wavelengthCm);
+    }
 
-        // Fixed brightness for visibility
-        uint8_t fixedBrightness = 255;
+    void render(const LightingParams &P,
+                const SpatialMap &S,
+                CRGB *mainLeds, uint16_t nMain,
+                CRGB *detailLeds, uint16_t nDetail,
+                uint32_t nowMs, float dt) override
+    {
+        // One wave period every two beats
+        uint16_t phaseTurns = P.beat.phase(128);
+
+        const ConfigPalette &pal = P.palette();
 
         // Main brightness pulse
-        uint8_t pulse = (sin(phase) * 0.5f + 0.5f) * fixedBrightness;
-        fill_solid(mainLeds, nMain, CHSV(P.mainHue(), P.mainSat(), pulse));
+        uint8_t pulse = fxSin8(phaseTurns);
+        CRGB mainColor = pal.main();
+        mainColor.nscale8(scale8_video(pulse, pulse));
+        fill_solid(mainLeds, nMain, mainColor);
+
+        // Per LED only the value changes, dimmed with the same val^2 curve
+        // hsv2rgb applies
+        CRGB base = P.secondaryEnabled() ? pal.secondary() : pal.main();
 
         for (uint16_t i = 0; i < nDetail; i++)
         {
-            const Vec3 &v = S.pos(i);
-            // Apply spatial frequency based on wavelength
-            float wave = sin(v.z * spatialFrequency + phase);
-            wave = (wave * 0.5f + 0.5f); // map to 0..1
-
-            uint8_t bri = wave * fixedBrightness;
-
-            CHSV c = P.secondaryEnabled()
-                         ? CHSV(P.secondaryHue(), P.secondarySat(), bri)
-                         : CHSV(P.mainHue(), P.mainSat(), bri);
+            // Only the low 24 bits of the product matter, so let it wrap
+            uint16_t a = phaseTurns + (uint16_t)(((uint32_t)S.zQ8(i) * (uint32_t)turnsPerCm) >> 8);
+            uint8_t bri = fxSin8(a);
 
+            CRGB c = base;
+            c.nscale8(scale8_video(bri, bri));
             detailLeds[i] = c;
         }
     }
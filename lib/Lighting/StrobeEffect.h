@@ -0,0 +1,31 @@
+#pragma once
+#include "Effect.h"
+
+// Special1 strobe: main LEDs flash the config's main colour, detail LEDs
+// stay dark. Uses the active config, which is the strobe config while
+// Special1 is held.
+class StrobeEffect : public Effect
+{
+public:
+    // 255 -> ~30ms, 0 -> ~1000ms
+    static uint16_t periodMs(uint8_t speed)
+    {
+        return (uint16_t)(1000 - (speed * 970) / 255) + 30;
+    }
+
+    void render(const LightingParams &P,
+                const SpatialMap &,
+                CRGB *mainLeds, uint16_t nMain,
+                CRGB *detailLeds, uint16_t nDetail,
+                uint32_t nowMs, float) override
+    {
+        uint16_t period = periodMs(P.speed());
+        const bool on = (nowMs % period) < (period / 2);
+
+        if (on)
+            fill_solid(mainLeds, nMain, P.palette().main());
+        else
+            fill_solid(mainLeds, nMain, CRGB::Black);
+        fill_solid(detailLeds, nDetail, CRGB::Black);
+    }
+};
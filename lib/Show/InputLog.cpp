@@ -0,0 +1,277 @@
+#include "InputLog.h"
+#include <string.h>
+
+// Frame head flags (low bits of the first varint)
+static const uint8_t FRAME_EVENTS = 1;
+static const uint8_t FRAME_AUDIO = 2;
+static const uint8_t FRAME_HASH = 4;
+static const uint8_t FRAME_FLAG_BITS = 3;
+
+// Longest encoded frame: head, events, audio, hash
+// (an event is its action, value and age, each value up to a 5-byte varint)
+static const size_t MAX_FRAME_BYTES = 10 + 1 + INPUT_LOG_MAX_EVENTS * 11 + 16 + 4;
+
+static inline uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static inline int64_t unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+static uint8_t *putVarint(uint8_t *p, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static bool getVarint(const std::vector<uint8_t> &b, size_t &pos, uint64_t &v)
+{
+    v = 0;
+    for (uint8_t shift = 0; shift < 64 && pos < b.size(); shift += 7)
+    {
+        uint8_t c = b[pos++];
+        v |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static bool audioChanged(const AudioFeatures &a, const AudioFeatures &b)
+{
+    return a.active != b.active || a.bpm != b.bpm || a.confidence != b.confidence ||
+           a.onsetCount != b.onsetCount || a.lastOnsetMs != b.lastOnsetMs;
+}
+
+uint32_t inputLogHash(const CRGB *mainLeds, uint16_t mainCount,
+                      const CRGB *detailLeds, uint16_t detailCount)
+{
+    uint32_t h = 2166136261u;
+    const uint8_t *p = (const uint8_t *)mainLeds;
+    for (size_t i = 0; i < (size_t)mainCount * 3; i++)
+        h = (h ^ p[i]) * 16777619u;
+    p = (const uint8_t *)detailLeds;
+    for (size_t i = 0; i < (size_t)detailCount * 3; i++)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+// ============ Writer ============
+
+void InputLogWriter::begin(const InputLogHeader &header, size_t capacity)
+{
+    buf.clear();
+    buf.reserve(capacity);
+    cap = capacity;
+    isFull = capacity < sizeof(header);
+    if (isFull)
+        return;
+
+    const uint8_t *h = (const uint8_t *)&header;
+    buf.insert(buf.end(), h, h + sizeof(header));
+    periodUs = header.periodUs;
+    lastUs = header.startUs;
+    frameCount = 0;
+    lastAudio = AudioFeatures();
+}
+
+void InputLogWriter::frame(const FrameTime &ft, const InputEvent *events, uint8_t count,
+                           const AudioFeatures &audio,
+                           const CRGB *mainLeds, uint16_t mainCount,
+                           const CRGB *detailLeds, uint16_t detailCount)
+{
+    if (!active())
+        return;
+    if (count > INPUT_LOG_MAX_EVENTS)
+        count = INPUT_LOG_MAX_EVENTS;
+
+    uint8_t flags = 0;
+    if (count)
+        flags |= FRAME_EVENTS;
+    if (audioChanged(audio, lastAudio))
+        flags |= FRAME_AUDIO;
+    if (frameCount % INPUT_LOG_HASH_INTERVAL == 0)
+        flags |= FRAME_HASH;
+
+    uint8_t tmp[MAX_FRAME_BYTES];
+    int64_t jitter = (int64_t)(ft.nowUs - lastUs) - (int64_t)periodUs;
+    uint8_t *p = putVarint(tmp, (zigzag(jitter) << FRAME_FLAG_BITS) | flags);
+
+    if (flags & FRAME_EVENTS)
+    {
+        *p++ = count;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            *p++ = (uint8_t)events[i].action;
+            p = putVarint(p, zigzag(events[i].value));
+            // Sampler time relative to the frame; signed, the sampler can
+            // stamp an event after the frame clock was read
+            p = putVarint(p, zigzag((int32_t)(ft.nowMs - events[i].timeMs)));
+        }
+    }
+    if (flags & FRAME_AUDIO)
+    {
+        *p++ = audio.active ? 1 : 0;
+        memcpy(p, &audio.bpm, sizeof(float));
+        p += sizeof(float);
+        *p++ = audio.confidence;
+        p = putVarint(p, (uint32_t)(audio.onsetCount - lastAudio.onsetCount));
+        p = putVarint(p, (uint32_t)(ft.nowMs - audio.lastOnsetMs));
+    }
+    if (flags & FRAME_HASH)
+    {
+        uint32_t h = inputLogHash(mainLeds, mainCount, detailLeds, detailCount);
+        memcpy(p, &h, sizeof(h));
+        p += sizeof(h);
+    }
+
+    // Only whole frames go in
+    size_t n = p - tmp;
+    if (buf.size() + n > cap)
+    {
+        isFull = true;
+        return;
+    }
+    buf.insert(buf.end(), tmp, p);
+
+    lastUs = ft.nowUs;
+    lastAudio = audio;
+    frameCount++;
+}
+
+// ============ Reader ============
+
+static int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+bool InputLogReader::load(const uint8_t *data, size_t len)
+{
+    buf.clear();
+    pos = 0;
+
+    if (len >= 4 && memcmp(data, "TLOG", 4) == 0)
+        buf.assign(data, data + len);
+    else
+    {
+        // Hex dump: the lines between the HUD's start and end markers, each
+        // "#<hex>" (whatever a serial monitor put in front is skipped)
+        const char *end = (const char *)data + len;
+        const char *line = (const char *)memmem(data, len, "--- input log", 13);
+        while (line)
+        {
+            line = (const char *)memchr(line, '\n', end - line);
+            if (!line)
+                break;
+            line++;
+            const char *eol = (const char *)memchr(line, '\n', end - line);
+            if (!eol)
+                eol = end;
+            if (memmem(line, eol - line, "--- end", 7))
+                break;
+
+            const char *h = (const char *)memchr(line, '#', eol - line);
+            if (h)
+            {
+                for (h++; h + 1 < eol; h += 2)
+                {
+                    int hi = hexDigit(h[0]), lo = hexDigit(h[1]);
+                    if (hi < 0 || lo < 0)
+                        break;
+                    buf.push_back((uint8_t)(hi << 4 | lo));
+                }
+            }
+            line = eol;
+        }
+    }
+
+    if (buf.size() < sizeof(hdr))
+        return false;
+    memcpy(&hdr, buf.data(), sizeof(hdr));
+    if (memcmp(hdr.magic, "TLOG", 4) != 0 || hdr.version != INPUT_LOG_VERSION)
+        return false;
+
+    pos = sizeof(hdr);
+    lastUs = hdr.startUs;
+    damaged = false;
+    return true;
+}
+
+bool InputLogReader::next(InputLogFrame &f, AudioFeatures &audio)
+{
+    if (pos >= buf.size())
+        return false;
+    if (!readFrame(f, audio))
+    {
+        damaged = true;
+        return false;
+    }
+    return true;
+}
+
+bool InputLogReader::readFrame(InputLogFrame &f, AudioFeatures &audio)
+{
+    uint64_t head;
+    if (!getVarint(buf, pos, head))
+        return false;
+
+    uint8_t flags = head & ((1 << FRAME_FLAG_BITS) - 1);
+    f.nowUs = lastUs + hdr.periodUs + unzigzag(head >> FRAME_FLAG_BITS);
+    lastUs = f.nowUs;
+    uint32_t nowMs = (uint32_t)(f.nowUs / 1000);
+
+    f.eventCount = 0;
+    if (flags & FRAME_EVENTS)
+    {
+        if (pos >= buf.size())
+            return false;
+        uint8_t count = buf[pos++];
+        if (count > INPUT_LOG_MAX_EVENTS)
+            return false;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            uint64_t v, age;
+            if (pos >= buf.size())
+                return false;
+            f.events[i].action = (InputAction)buf[pos++];
+            if (!getVarint(buf, pos, v) || !getVarint(buf, pos, age))
+                return false;
+            f.events[i].value = (int)unzigzag(v);
+            f.events[i].timeMs = nowMs - (uint32_t)(int32_t)unzigzag(age);
+        }
+        f.eventCount = count;
+    }
+
+    if (flags & FRAME_AUDIO)
+    {
+        uint64_t onsets, onsetAge;
+        if (pos + 6 > buf.size())
+            return false;
+        audio.active = buf[pos++] != 0;
+        memcpy(&audio.bpm, &buf[pos], sizeof(float));
+        pos += sizeof(float);
+        audio.confidence = buf[pos++];
+        if (!getVarint(buf, pos, onsets) || !getVarint(buf, pos, onsetAge))
+            return false;
+        audio.onsetCount += (uint32_t)onsets;
+        audio.lastOnsetMs = nowMs - (uint32_t)onsetAge;
+    }
+
+    f.hasHash = (flags & FRAME_HASH) != 0;
+    if (f.hasHash)
+    {
+        if (pos + sizeof(f.hash) > buf.size())
+            return false;
+        memcpy(&f.hash, &buf[pos], sizeof(f.hash));
+        pos += sizeof(f.hash);
+    }
+    return true;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <FastLED.h>
+#include "ConfigManager.h"
+#include "FrameScheduler.h"
+#include "InputEvent.h"
+#include "AudioFeatures.h"
+
+#define INPUT_LOG_VERSION 2
+
+// Frames between two output checksums; a replay compares its own
+#define INPUT_LOG_HASH_INTERVAL 100
+
+// Most events one frame can carry (the input queue's size)
+#define INPUT_LOG_MAX_EVENTS 32
+
+// Everything a replay needs to start from the same state as the recording
+struct __attribute__((packed)) InputLogHeader
+{
+    char magic[4]; // "TLOG"
+    uint8_t version;
+    uint8_t mainCount;
+    uint16_t detailCount;
+    uint32_t periodUs; // frame period; frame times are stored relative to it
+    uint32_t seed;     // ShowController::seed()
+    uint64_t startUs;  // FrameTime::nowUs before the first frame
+    float minBpm;      // P.beat range
+    float maxBpm;
+    ConfigSnapshot config;
+};
+
+// One recorded frame
+struct InputLogFrame
+{
+    uint64_t nowUs = 0;
+    InputEvent events[INPUT_LOG_MAX_EVENTS];
+    uint8_t eventCount = 0;
+    bool hasHash = false;
+    uint32_t hash = 0;
+};
+
+// Records what ShowController was fed, frame by frame, into a fixed RAM
+// buffer: the frame time, the input events handled in it with their
+// sampler times, the audio fields the tempo follows (when they change) and
+// every INPUT_LOG_HASH_INTERVAL frames a checksum of the rendered LEDs.
+//
+// A frame without events or audio changes and with the usual timing jitter
+// takes one byte. Recording stops (full() turns true) when the buffer is.
+class InputLogWriter
+{
+public:
+    // Reserves the buffer and writes the header
+    void begin(const InputLogHeader &header, size_t capacity);
+    bool active() const { return !buf.empty() && !isFull; }
+    bool full() const { return isFull; }
+
+    // After the frame rendered. audio is P.audio as used for it.
+    void frame(const FrameTime &ft, const InputEvent *events, uint8_t count,
+               const AudioFeatures &audio,
+               const CRGB *mainLeds, uint16_t mainCount,
+               const CRGB *detailLeds, uint16_t detailCount);
+
+    const uint8_t *data() const { return buf.data(); }
+    size_t size() const { return buf.size(); }
+    uint32_t frames() const { return frameCount; }
+
+private:
+    std::vector<uint8_t> buf;
+    size_t cap = 0;
+    bool isFull = false;
+    uint32_t periodUs = 0;
+    uint64_t lastUs = 0;
+    uint32_t frameCount = 0;
+    AudioFeatures lastAudio;
+};
+
+// Reads a log back: the raw bytes or the hex dump the HUD prints
+class InputLogReader
+{
+public:
+    bool load(const uint8_t *data, size_t len);
+    const InputLogHeader &header() const { return hdr; }
+
+    // Next frame; audio is updated in place when the frame changed it.
+    // False at the end of the log, or at a damaged frame (then isDamaged()).
+    bool next(InputLogFrame &f, AudioFeatures &audio);
+    bool isDamaged() const { return damaged; }
+
+private:
+    std::vector<uint8_t> buf;
+    size_t pos = 0;
+    InputLogHeader hdr;
+    uint64_t lastUs = 0;
+    bool damaged = false;
+
+    bool readFrame(InputLogFrame &f, AudioFeatures &audio);
+};
+
+// FNV-1a over both LED buffers
+uint32_t inputLogHash(const CRGB *mainLeds, uint16_t mainCount,
+                      const CRGB *detailLeds, uint16_t detailCount);
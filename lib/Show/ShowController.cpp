@@ -0,0 +1,286 @@
+#include "ShowController.h"
+
+ShowController::ShowController(LightingParams &params, ConfigManager &configs)
+    : P(params), configMgr(configs)
+{
+}
+
+void ShowController::begin(uint16_t mainCount, uint16_t detailCount, FrameProfiler *prof)
+{
+    profiler = prof;
+
+    // Configure EnergyBurst effect secondary brightness range
+    // secondaryBrightnessMin (26 ≈ 10% brightness) - brightness at intensity=0
+    // secondaryBrightnessMax (51 ≈ 20% brightness) - brightness at intensity=255
+    // Values scale linearly with intensity parameter
+    energyBurstFx.setSecondaryBrightnessRange(26, 51);
+
+    // Configure EnergyBurst explosion height threshold
+    // 0.0 = bottom of LEDs, 1.0 = top of LEDs
+    // At 0.2, explosion only cancels if intensity is very low (spinning point below 20% height)
+    energyBurstFx.setExplosionHeightThreshold(0.2f);
+
+    // Point P to default config initially
+    P.activeConfig = &configMgr.getConfig(ConfigMode::Default);
+    P.activeMode = ConfigMode::Default;
+    P.effectID = configMgr.getBootEffectID();
+
+    // Register effects (switches crossfade over EFFECT_CROSSFADE_MS)
+    fx.begin(mainCount, detailCount);
+    fx.add(&waveFx, "Wave");
+    fx.add(&helixFx, "Helix");
+    fx.add(&sphereFx, "Sphere");
+    fx.add(&rainFx, "Rain");
+
+    // Name profiler effect slots
+    if (profiler)
+    {
+        for (uint8_t i = 0; i < fx.count(); i++)
+            profiler->setEffectName(i, fx.nameOf(i));
+        profiler->setEffectName(PROFILE_SLOT_STROBE, "Strobe");
+        profiler->setEffectName(PROFILE_SLOT_ENERGY_BURST, "EnergyBurst");
+        profiler->setEffectName(PROFILE_SLOT_EMERGENCY, "Emergency");
+    }
+
+    // Compose layers (all opaque and full-frame, so only the top enabled one renders)
+    compositor.begin(mainCount, detailCount);
+    compositor.setProfiler(profiler);
+    effectLayer = compositor.add(&fx);
+    energyBurstLayer = compositor.add(&energyBurstFx);
+    emergencyLayer = compositor.add(&emergencyFx);
+    strobeLayer = compositor.add(&strobeFx);
+    compositor.setProfileSlot(energyBurstLayer, PROFILE_SLOT_ENERGY_BURST);
+    compositor.setProfileSlot(emergencyLayer, PROFILE_SLOT_EMERGENCY);
+    compositor.setProfileSlot(strobeLayer, PROFILE_SLOT_STROBE);
+}
+
+void ShowController::seed(uint32_t s)
+{
+    rainFx.seed(s);
+}
+
+bool ShowController::takeDirty()
+{
+    bool d = dirty;
+    dirty = false;
+    return d;
+}
+
+// Energy burst always restarts from the bottom
+void ShowController::resetEnergyBurstIntensity()
+{
+    EffectConfig &cfg = configMgr.getConfig(ConfigMode::Special2_EnergyBurst);
+    cfg.intensity = 0;
+    cfg.touch();
+}
+
+// Steps through the preset bank (position 0 = the live Default config)
+void ShowController::stepScene(int delta)
+{
+    const int positions = SCENE_COUNT + 1;
+    int pos = (((int)configMgr.scenePosition() + delta) % positions + positions) % positions;
+
+    const Scene *scene = configMgr.recallScene((uint8_t)pos);
+    P.activeConfig = &configMgr.getActiveConfig();
+    if (scene && !scene->blank)
+    {
+        P.effectID = scene->effectID % fx.count();
+        P.brightness = scene->brightness;
+        fx.setEffect(P.effectID, true); // a recalled look cuts in, no crossfade
+    }
+    Serial.printf("→ Scene: %s\n", scene ? scene->name : "Live");
+    markDirty();
+}
+
+void ShowController::handleInput(const InputEvent &ev, uint32_t now)
+{
+    // Handle mode switching events
+    switch (ev.action)
+    {
+    case InputAction::EnterSpecial1: // Enc5 pressed
+        // Cancel EnergyBurst if active
+        if (P.energyBurstState != EnergyBurstState::Inactive)
+        {
+            P.energyBurstState = EnergyBurstState::Inactive;
+            energyBurstFx.reset();
+            resetEnergyBurstIntensity();
+        }
+        configMgr.setMode(ConfigMode::Special1_Strobe);
+        P.activeConfig = &configMgr.getActiveConfig();
+        P.activeMode = ConfigMode::Special1_Strobe;
+        P.strobeActive = true;
+        Serial.println("→ Special1: Strobe ON");
+        markDirty();
+        break;
+
+    case InputAction::ExitSpecial1: // Enc5 released
+        configMgr.setMode(ConfigMode::Default);
+        P.activeConfig = &configMgr.getActiveConfig();
+        P.activeMode = ConfigMode::Default;
+        P.strobeActive = false;
+        Serial.println("→ Default mode");
+        markDirty();
+        break;
+
+    case InputAction::EnterSpecial2: // Enc4 pressed
+    {
+        EnergyBurstState currentState = P.energyBurstState;
+
+        if (currentState == EnergyBurstState::Inactive)
+        {
+            // Start energy buildup
+            configMgr.setMode(ConfigMode::Special2_EnergyBurst);
+            P.activeConfig = &configMgr.getActiveConfig();
+            P.activeMode = ConfigMode::Special2_EnergyBurst;
+            P.energyBurstState = EnergyBurstState::BuildingUp;
+            energyBurstFx.setState(EnergyBurstState::BuildingUp, now);
+            Serial.println("→ Special2: Energy BuildUp");
+            markDirty();
+        }
+        else if (currentState == EnergyBurstState::BuildingUp)
+        {
+            // Check height threshold (intensity maps to height ratio: 0-255 → 0.0-1.0)
+            float heightRatio = P.activeConfig->intensity / 255.0f;
+            float threshold = energyBurstFx.getExplosionHeightThreshold();
+
+            if (heightRatio >= threshold)
+            {
+                // Trigger explosion
+                P.energyBurstState = EnergyBurstState::Exploding;
+                energyBurstFx.setState(EnergyBurstState::Exploding, now);
+                P.explosionStartTime = now;
+                Serial.println("→ Special2: EXPLOSION!");
+                markDirty();
+            }
+            else
+            {
+                // Cancel effect - height too low
+                configMgr.setMode(ConfigMode::Default);
+                P.activeConfig = &configMgr.getActiveConfig();
+                P.activeMode = ConfigMode::Default;
+                P.energyBurstState = EnergyBurstState::Inactive;
+                energyBurstFx.reset();
+                resetEnergyBurstIntensity();
+                Serial.println("→ Default mode (Energy cancelled - height below threshold)");
+                markDirty();
+            }
+        }
+        break;
+    }
+
+    case InputAction::EnterSpecial3: // Enc3 pressed
+        // Cancel EnergyBurst if active
+        if (P.energyBurstState != EnergyBurstState::Inactive)
+        {
+            P.energyBurstState = EnergyBurstState::Inactive;
+            energyBurstFx.reset();
+            resetEnergyBurstIntensity();
+        }
+        configMgr.setMode(ConfigMode::Special3_Emergency);
+        P.activeConfig = &configMgr.getActiveConfig();
+        P.activeMode = ConfigMode::Special3_Emergency;
+        P.emergencyActive = true;
+        Serial.println("→ Special3: Emergency Lights ON");
+        markDirty();
+        break;
+
+    case InputAction::ExitSpecial3: // Enc3 released
+        configMgr.setMode(ConfigMode::Default);
+        P.activeConfig = &configMgr.getActiveConfig();
+        P.activeMode = ConfigMode::Default;
+        P.emergencyActive = false;
+        Serial.println("→ Default mode");
+        markDirty();
+        break;
+
+    case InputAction::TapTempo: // Enc1 clicked; timed by the sampler at the press
+        P.beat.tap(ev.timeMs, now);
+        markDirty();
+        break;
+
+    case InputAction::SceneStep: // Enc2 held + Enc3 turned
+        if (P.activeMode == ConfigMode::Default)
+            stepScene(ev.value);
+        break;
+
+    case InputAction::SaveConfigs: // Enc4 + Enc5 held 5s
+        configMgr.setBootEffectID(P.effectID);
+        configMgr.captureScene(P.effectID, P.brightness);
+        configMgr.save();
+        break;
+
+    default:
+        // Let mapper handle all other actions
+        bool applied;
+        {
+            ProfileScope scope(profiler, ProfileStage::Mapper);
+            applied = mapper.apply(ev, P);
+        }
+        if (applied)
+        {
+            // Turning Speed hands the tempo back from tap to the encoder
+            if (ev.action == InputAction::SpeedAdjust && P.activeMode == ConfigMode::Default)
+                P.beat.releaseTap();
+
+            // Wrap effect ID (handle both positive and negative wrapping)
+            // Convert to signed to handle negative deltas correctly
+            int16_t effectCount = (int16_t)fx.count();
+            int16_t signedEffectID = (int16_t)P.effectID;
+
+            // Wrap around: ensure result is always in range [0, effectCount)
+            signedEffectID = ((signedEffectID % effectCount) + effectCount) % effectCount;
+            P.effectID = (uint8_t)signedEffectID;
+
+            if (fx.setEffect(P.effectID))
+            {
+                markDirty();
+            }
+            // Mark dirty for any parameter changes
+            markDirty();
+        }
+        break;
+    }
+}
+
+void ShowController::update(const FrameTime &ft)
+{
+    uint32_t now = ft.nowMs;
+
+    // Check if explosion finished (auto-exit after 2s)
+    if (P.energyBurstState == EnergyBurstState::Exploding)
+    {
+        if (now - P.explosionStartTime >= 2000)
+        {
+            configMgr.setMode(ConfigMode::Default);
+            P.activeConfig = &configMgr.getActiveConfig();
+            P.activeMode = ConfigMode::Default;
+            P.energyBurstState = EnergyBurstState::Inactive;
+            energyBurstFx.reset();
+            resetEnergyBurstIntensity();
+            Serial.println("→ Default mode (Explosion complete)");
+            markDirty();
+        }
+    }
+
+    // Tempo: the music when locked, else tap tempo, else the Default
+    // config's Speed. Advanced once here for every effect.
+    P.beat.setSpeed(configMgr.getConfig(ConfigMode::Default).speed);
+    P.beat.syncAudio(P.audio, now);
+    P.beat.update(ft.dt);
+}
+
+void ShowController::render(const SpatialMap &map, CRGB *mainLeds, uint16_t mainCount,
+                            CRGB *detailLeds, uint16_t detailCount, const FrameTime &ft)
+{
+    // Enable layers for the active mode
+    fx.setEffect(P.effectID);
+    compositor.setProfileSlot(effectLayer, P.effectID);
+    compositor.setEnabled(effectLayer, P.activeMode == ConfigMode::Default);
+    compositor.setEnabled(energyBurstLayer, P.activeMode == ConfigMode::Special2_EnergyBurst &&
+                                                P.energyBurstState != EnergyBurstState::Inactive);
+    compositor.setEnabled(emergencyLayer, P.activeMode == ConfigMode::Special3_Emergency && P.emergencyActive);
+    compositor.setEnabled(strobeLayer, P.strobeActive);
+
+    ProfileScope scope(profiler, ProfileStage::Render);
+    compositor.render(P, map, mainLeds, mainCount, detailLeds, detailCount, ft.nowMs, ft.dt);
+}
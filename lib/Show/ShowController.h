@@ -0,0 +1,82 @@
+#pragma once
+#include <Arduino.h>
+#include "LightingParams.h"
+#include "SpatialMap.h"
+#include "ConfigManager.h"
+#include "EffectManager.h"
+#include "Compositor.h"
+#include "FrameProfiler.h"
+#include "FrameScheduler.h"
+#include "InputEvent.h"
+#include "InputMapper.h"
+
+#include "SpatialWaveEffect.h"
+#include "DoubleHelixEffect.h"
+#include "EnergyBurstEffect.h"
+#include "EmergencyEffect.h"
+#include "SphereEffect.h"
+#include "RainEffect.h"
+#include "StrobeEffect.h"
+
+// Everything between an InputEvent and a rendered frame: mode switching,
+// the effects and the layer stack, timers and tempo.
+//
+// Nothing in here touches hardware or reads a clock; time comes in with the
+// events and the FrameTime. The firmware and the host replay run the same
+// code, so a recorded input stream renders the same frames on both.
+class ShowController
+{
+public:
+    ShowController(LightingParams &params, ConfigManager &configs);
+
+    // After ConfigManager::begin(). The profiler (optional) gets the
+    // effect slot names and the Mapper/effect timings.
+    void begin(uint16_t mainCount, uint16_t detailCount, FrameProfiler *prof = nullptr);
+
+    // Seeds the effects' randomness (Rain)
+    void seed(uint32_t s);
+
+    // Mode switching and parameter changes for one input event
+    void handleInput(const InputEvent &ev, uint32_t now);
+
+    // Once per frame after the inputs: auto-exit timers and tempo
+    void update(const FrameTime &ft);
+
+    // Enables the layers for the active mode and renders them
+    void render(const SpatialMap &map, CRGB *mainLeds, uint16_t mainCount,
+                CRGB *detailLeds, uint16_t detailCount, const FrameTime &ft);
+
+    // True once after anything the HUD shows has changed
+    bool takeDirty();
+
+    EffectManager &effects() { return fx; }
+
+    // Effect slots 0..n-1 are the EffectManager effects; specials sit at the end
+    static const uint8_t PROFILE_SLOT_STROBE = FrameProfiler::MAX_EFFECTS - 3;
+    static const uint8_t PROFILE_SLOT_ENERGY_BURST = FrameProfiler::MAX_EFFECTS - 2;
+    static const uint8_t PROFILE_SLOT_EMERGENCY = FrameProfiler::MAX_EFFECTS - 1;
+
+private:
+    LightingParams &P;
+    ConfigManager &configMgr;
+    InputMapper mapper;
+    FrameProfiler *profiler = nullptr;
+    bool dirty = true;
+
+    EffectManager fx;
+    SpatialWaveEffect waveFx;
+    DoubleHelixEffect helixFx;
+    EnergyBurstEffect energyBurstFx;
+    EmergencyEffect emergencyFx;
+    SphereEffect sphereFx;
+    RainEffect rainFx;
+    StrobeEffect strobeFx;
+
+    // Layer stack, bottom first; each special mode covers everything below it
+    Compositor compositor;
+    uint8_t effectLayer = 0, energyBurstLayer = 0, emergencyLayer = 0, strobeLayer = 0;
+
+    void markDirty() { dirty = true; }
+    void resetEnergyBurstIntensity();
+    void stepScene(int delta);
+};
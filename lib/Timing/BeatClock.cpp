@@ -0,0 +1,111 @@
+#include "BeatClock.h"
+#include <math.h>
+
+void BeatClock::setRange(float lo, float hi)
+{
+    minBpm = lo;
+    maxBpm = hi;
+}
+
+void BeatClock::setSpeed(uint8_t speed)
+{
+    manualBpm = minBpm + (speed / 255.0f) * (maxBpm - minBpm);
+}
+
+// Signed distance from a position to the nearest beat, -0.5..0.5 beat (Q16)
+static inline int32_t beatError(uint32_t at)
+{
+    return (int16_t)(uint16_t)at;
+}
+
+// Grid position ageMs ago, at the current tempo; only the position within
+// a beat is kept, so the Q16 conversion stays in range
+uint32_t BeatClock::posAgo(int32_t ageMs) const
+{
+    if (ageMs < 0)
+        ageMs = 0;
+    float beatsAgo = ageMs * current / 60000.0f;
+    beatsAgo -= floorf(beatsAgo);
+    return pos - (uint32_t)(beatsAgo * 65536.0f);
+}
+
+void BeatClock::tap(uint32_t tapMs, uint32_t nowMs)
+{
+    if (tapCount == 0 || tapMs - lastTapMs > BEAT_CLOCK_TAP_TIMEOUT_MS)
+    {
+        tapCount = 1;
+        firstTapMs = tapMs;
+    }
+    else if (tapCount < 255)
+        tapCount++;
+    lastTapMs = tapMs;
+
+    if (tapCount < BEAT_CLOCK_MIN_TAPS || tapMs == firstTapMs)
+        return;
+
+    float bpm = 60000.0f * (tapCount - 1) / (tapMs - firstTapMs);
+    if (bpm < minBpm)
+        bpm = minBpm;
+    if (bpm > maxBpm)
+        bpm = maxBpm;
+    tapBpm = bpm;
+    tapActive = true;
+
+    // Slide the grid so the press lands on a beat: the grid has moved on
+    // by the click, the debounce and up to a frame since
+    pendingQ16 = -beatError(posAgo((int32_t)(nowMs - tapMs)));
+}
+
+void BeatClock::syncAudio(const AudioFeatures &audio, uint32_t nowMs)
+{
+    audioLocked = audio.active && audio.bpm > 0.0f &&
+                  audio.confidence >= BEAT_CLOCK_AUDIO_MIN_CONFIDENCE;
+    if (audioLocked)
+        audioBpm = audio.bpm;
+
+    if (audioLocked && audio.onsetCount != seenOnsets)
+    {
+        // Where the grid was when the onset happened. The audio task stamps
+        // onsets with millis() and can be ahead of the frame clock; such an
+        // onset happened "now" (posAgo clamps the age to 0).
+        int32_t err = beatError(posAgo((int32_t)(nowMs - audio.lastOnsetMs)));
+
+        // Onsets near the grid count fully, off-beat ones (hats) hardly at all
+        int32_t weight = 32768 - (err < 0 ? -err : err);
+        pendingQ16 -= (err * weight / 32768) / BEAT_CLOCK_PHASE_PULL;
+    }
+    seenOnsets = audio.onsetCount;
+}
+
+void BeatClock::update(float dt)
+{
+    if (audioLocked)
+    {
+        src = TempoSource::Audio;
+        current = audioBpm;
+    }
+    else if (tapActive)
+    {
+        src = TempoSource::Tap;
+        current = tapBpm;
+    }
+    else
+    {
+        src = TempoSource::Manual;
+        current = manualBpm;
+    }
+
+    float adv = current / 60.0f * dt * 65536.0f + posFrac;
+    uint32_t step = (uint32_t)adv;
+    posFrac = adv - step;
+
+    // Phase corrections are spread out, at most half a frame's step at a
+    // time, so the clock never stops or runs backwards
+    int32_t limit = (int32_t)(step / 2);
+    int32_t c = pendingQ16 > limit ? limit : (pendingQ16 < -limit ? -limit : pendingQ16);
+    pendingQ16 -= c;
+
+    uint32_t old = pos;
+    pos += step + c;
+    crossed = (pos >> 16) != (old >> 16);
+}
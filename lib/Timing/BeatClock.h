@@ -0,0 +1,105 @@
+#pragma once
+#include <stdint.h>
+#include "AudioFeatures.h"
+
+// Default manual tempo range (Speed 0..255); main.cpp sets its own
+#define BEAT_CLOCK_MIN_BPM 50.0f
+#define BEAT_CLOCK_MAX_BPM 180.0f
+
+#define BEAT_CLOCK_BEATS_PER_BAR 4
+
+// Tap tempo: taps further apart than the timeout start a new sequence;
+// the tempo follows from the MIN_TAPS-th tap on (averaged over the sequence)
+#define BEAT_CLOCK_TAP_TIMEOUT_MS 2000
+#define BEAT_CLOCK_MIN_TAPS 3
+
+// Audio lock: tracked tempo is used above this confidence, and each onset
+// pulls the phase up to 1/PULL of the way onto it (less the further it is
+// from the nearest beat)
+#define BEAT_CLOCK_AUDIO_MIN_CONFIDENCE 64
+#define BEAT_CLOCK_PHASE_PULL 4
+
+enum class TempoSource : uint8_t
+{
+    Manual, // Speed encoder
+    Tap,
+    Audio
+};
+
+// One tempo and beat position shared by every effect.
+//
+// Position counts beats in Q16 (the low 16 bits are the phase within the
+// beat) and only ever advances, so tempo changes and effect switches never
+// make the animation jump. Advanced once per frame by update(); effects
+// read phases from it instead of integrating their own.
+class BeatClock
+{
+public:
+    void setRange(float minBpm, float maxBpm);
+
+    // Manual tempo from the Speed value (0..255 across the range)
+    void setSpeed(uint8_t speed);
+
+    // Tap tempo; the tap also marks a beat. tapMs is when it was pressed,
+    // nowMs the frame time it's handled at (a click is decided on release)
+    void tap(uint32_t tapMs, uint32_t nowMs);
+    // Back to the manual tempo (Speed was turned)
+    void releaseTap() { tapActive = false; }
+
+    // Follow the audio tempo while it's locked, and its onsets for phase
+    void syncAudio(const AudioFeatures &audio, uint32_t nowMs);
+
+    // Once per frame, after the tempo inputs
+    void update(float dt);
+
+    float bpm() const { return current; }
+    TempoSource source() const { return src; }
+
+    uint32_t position() const { return pos; } // beats, Q16 (wraps)
+    uint32_t beat() const { return pos >> 16; }
+    uint16_t beatPhase() const { return (uint16_t)pos; }
+    uint8_t beatInBar() const { return (uint8_t)(beat() % BEAT_CLOCK_BEATS_PER_BAR); }
+    uint16_t barPhase() const
+    {
+        return (uint16_t)(((uint32_t)beatInBar() * 65536 + beatPhase()) / BEAT_CLOCK_BEATS_PER_BAR);
+    }
+    // True on the frame a new beat started
+    bool beatStarted() const { return crossed; }
+
+    // Phase (one turn = 65536) of a cycle that runs cyclesPerBeatQ8/256
+    // times per beat, e.g. 128 = one cycle every two beats
+    uint16_t phase(uint16_t cyclesPerBeatQ8) const
+    {
+        return (uint16_t)((pos * cyclesPerBeatQ8) >> 8);
+    }
+
+    // Index of the current 1/slotsPerBeatQ8*256 beat slot; changes when a
+    // new slot starts (for spawning things in time)
+    uint32_t slot(uint32_t slotsPerBeatQ8) const
+    {
+        return (uint32_t)(((uint64_t)pos * slotsPerBeatQ8) >> 24);
+    }
+
+private:
+    float minBpm = BEAT_CLOCK_MIN_BPM;
+    float maxBpm = BEAT_CLOCK_MAX_BPM;
+    float manualBpm = 120.0f;
+    float tapBpm = 120.0f;
+    float audioBpm = 0.0f;
+    float current = 120.0f;
+    TempoSource src = TempoSource::Manual;
+
+    uint32_t pos = 0;
+    float posFrac = 0.0f; // sub-Q16 remainder so slow tempos don't drift
+    bool crossed = false;
+    int32_t pendingQ16 = 0; // phase correction still to apply
+
+    bool tapActive = false;
+    uint8_t tapCount = 0;
+    uint32_t firstTapMs = 0;
+    uint32_t lastTapMs = 0;
+
+    bool audioLocked = false;
+    uint32_t seenOnsets = 0;
+    uint32_t posAgo(int32_t ageMs) const;
+};
@@ -0,0 +1,142 @@
+#include "FrameProfiler.h"
+#include <string.h>
+
+// ============ StageHistogram ============
+
+void StageHistogram::reset()
+{
+    memset(buckets, 0, sizeof(buckets));
+    n = 0;
+    lo = 0xFFFFFFFF;
+    hi = 0;
+    sum = 0;
+}
+
+// Values 0-7 get their own bucket; above that, 4 buckets per power of two
+uint8_t StageHistogram::bucketFor(uint32_t v)
+{
+    if (v < 8)
+        return (uint8_t)v;
+
+    uint8_t msb = 31 - __builtin_clz(v);
+    uint8_t sub = (v >> (msb - 2)) & 3;
+    uint16_t idx = 8 + (msb - 3) * 4 + sub;
+    return idx < BUCKETS ? (uint8_t)idx : BUCKETS - 1;
+}
+
+uint32_t StageHistogram::bucketUpper(uint8_t idx)
+{
+    if (idx < 8)
+        return idx;
+
+    uint8_t msb = 3 + (idx - 8) / 4;
+    uint8_t sub = (idx - 8) % 4;
+    return ((uint32_t)(4 + sub + 1) << (msb - 2)) - 1;
+}
+
+void StageHistogram::add(uint32_t v)
+{
+    uint8_t b = bucketFor(v);
+    if (buckets[b] < 0xFFFF)
+        buckets[b]++;
+    n++;
+    sum += v;
+    if (v < lo)
+        lo = v;
+    if (v > hi)
+        hi = v;
+}
+
+uint32_t StageHistogram::percentile(uint8_t pct) const
+{
+    if (n == 0)
+        return 0;
+
+    uint32_t target = ((uint64_t)n * pct + 99) / 100;
+    uint32_t acc = 0;
+    for (uint8_t i = 0; i < BUCKETS; i++)
+    {
+        acc += buckets[i];
+        if (acc >= target)
+        {
+            uint32_t upper = bucketUpper(i);
+            return upper < hi ? upper : hi;
+        }
+    }
+    return hi;
+}
+
+// ============ FrameProfiler ============
+
+void FrameProfiler::begin()
+{
+#if defined(ESP32)
+    cyclesPerUs = getCpuFrequencyMhz();
+#endif
+    reset();
+}
+
+void FrameProfiler::reset()
+{
+    for (uint8_t i = 0; i < (uint8_t)ProfileStage::Count; i++)
+    {
+        cur[i].reset();
+        last[i].reset();
+    }
+    for (uint8_t i = 0; i < MAX_EFFECTS; i++)
+    {
+        curFx[i].reset();
+        lastFx[i].reset();
+    }
+    frames = 0;
+    haveLast = false;
+}
+
+void FrameProfiler::record(ProfileStage s, uint32_t c)
+{
+    cur[(uint8_t)s].add(c);
+}
+
+void FrameProfiler::recordEffect(uint8_t slot, uint32_t c)
+{
+    if (slot < MAX_EFFECTS)
+        curFx[slot].add(c);
+}
+
+void FrameProfiler::setEffectName(uint8_t slot, const char *name)
+{
+    if (slot < MAX_EFFECTS)
+        names[slot] = name;
+}
+
+void FrameProfiler::endFrame()
+{
+    if (++frames < WINDOW_FRAMES)
+        return;
+
+    // Roll the window
+    for (uint8_t i = 0; i < (uint8_t)ProfileStage::Count; i++)
+    {
+        last[i] = cur[i];
+        cur[i].reset();
+    }
+    for (uint8_t i = 0; i < MAX_EFFECTS; i++)
+    {
+        lastFx[i] = curFx[i];
+        curFx[i].reset();
+    }
+    frames = 0;
+    haveLast = true;
+}
+
+const StageHistogram &FrameProfiler::stage(ProfileStage s) const
+{
+    return haveLast ? last[(uint8_t)s] : cur[(uint8_t)s];
+}
+
+const StageHistogram &FrameProfiler::effect(uint8_t slot) const
+{
+    if (slot >= MAX_EFFECTS)
+        slot = 0;
+    return haveLast ? lastFx[slot] : curFx[slot];
+}
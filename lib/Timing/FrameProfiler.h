@@ -0,0 +1,107 @@
+#pragma once
+#include <stdint.h>
+#include <Arduino.h>
+
+// Stages of one frame, in pipeline order
+enum class ProfileStage : uint8_t
+{
+    Input = 0, // InputManager::poll
+    Mapper,    // InputMapper::apply
+    Render,    // effect render (all modes)
+    Blend,     // compositor overlay blending
+    Power,     // frame scan: power model + diff hash (present)
+    Dither,    // brightness + temporal dither to wire format (show task)
+    Show,      // transmission (show task)
+    Count
+};
+
+// Log-bucketed histogram of cycle counts (4 buckets per octave).
+// Percentiles resolve to the bucket's upper edge, i.e. within ~19%.
+class StageHistogram
+{
+public:
+    StageHistogram() { reset(); }
+
+    void reset();
+    void add(uint32_t cycles);
+
+    uint32_t count() const { return n; }
+    uint32_t minCycles() const { return n ? lo : 0; }
+    uint32_t maxCycles() const { return hi; }
+    uint32_t avgCycles() const { return n ? (uint32_t)(sum / n) : 0; }
+    uint32_t percentile(uint8_t pct) const;
+
+private:
+    static const uint8_t BUCKETS = 96; // covers up to 2^25 cycles (~140ms @ 240MHz)
+    static uint8_t bucketFor(uint32_t v);
+    static uint32_t bucketUpper(uint8_t idx);
+
+    uint16_t buckets[BUCKETS];
+    uint32_t n, lo, hi;
+    uint64_t sum;
+};
+
+// Per-stage and per-effect frame profiler.
+// Keeps a rolling window: every WINDOW_FRAMES the current window becomes the
+// reported one and a fresh window starts.
+// Not locked: record from loop()'s core only (other tasks hand their
+// timings over, see LedEngine::present()).
+class FrameProfiler
+{
+public:
+    static const uint8_t MAX_EFFECTS = 8;
+    static const uint16_t WINDOW_FRAMES = 500; // ~5s at 100 FPS
+
+    static inline uint32_t cycles()
+    {
+#if defined(ESP32)
+        return ESP.getCycleCount();
+#else
+        return micros();
+#endif
+    }
+
+    void begin();
+
+    void record(ProfileStage stage, uint32_t cycles);
+    void recordEffect(uint8_t slot, uint32_t cycles);
+    void setEffectName(uint8_t slot, const char *name);
+    void endFrame();
+    void reset();
+
+    // Reported window (last completed one, or the running one before the first rollover)
+    const StageHistogram &stage(ProfileStage s) const;
+    const StageHistogram &effect(uint8_t slot) const;
+    const char *effectName(uint8_t slot) const { return slot < MAX_EFFECTS ? names[slot] : nullptr; }
+    uint32_t windowFrames() const { return haveLast ? WINDOW_FRAMES : frames; }
+
+    float toUs(uint32_t c) const { return c / (float)cyclesPerUs; }
+
+private:
+    StageHistogram cur[(uint8_t)ProfileStage::Count];
+    StageHistogram last[(uint8_t)ProfileStage::Count];
+    StageHistogram curFx[MAX_EFFECTS];
+    StageHistogram lastFx[MAX_EFFECTS];
+    const char *names[MAX_EFFECTS] = {};
+    uint16_t frames = 0;
+    bool haveLast = false;
+    uint32_t cyclesPerUs = 1;
+};
+
+// Times a scope into one profiler stage
+class ProfileScope
+{
+public:
+    ProfileScope(FrameProfiler *p, ProfileStage s)
+        : prof(p), stage(s), start(FrameProfiler::cycles()) {}
+    ~ProfileScope()
+    {
+        if (prof)
+            prof->record(stage, FrameProfiler::cycles() - start);
+    }
+
+private:
+    FrameProfiler *prof;
+    ProfileStage stage;
+    uint32_t start;
+};
@@ -0,0 +1,94 @@
+#include "FrameScheduler.h"
+#include <Arduino.h>
+
+#if defined(ESP32)
+#include <esp_timer.h>
+#endif
+
+FrameScheduler::FrameScheduler(uint16_t targetFps)
+{
+    setTargetFps(targetFps);
+}
+
+void FrameScheduler::begin()
+{
+    frameStartUs = nowUs();
+    nextDeadline = frameStartUs;
+    ft = FrameTime();
+    ft.nowUs = frameStartUs;
+    ft.nowMs = (uint32_t)(frameStartUs / 1000);
+    st = Stats();
+}
+
+void FrameScheduler::setTargetFps(uint16_t target)
+{
+    fps = target ? target : 1;
+    periodUs = 1000000UL / fps;
+}
+
+uint64_t FrameScheduler::nowUs()
+{
+#if defined(ESP32)
+    return (uint64_t)esp_timer_get_time();
+#else
+    return (uint64_t)micros();
+#endif
+}
+
+const FrameTime &FrameScheduler::waitForFrame()
+{
+    uint64_t now = nowUs();
+
+    if (now < nextDeadline)
+    {
+        // Sleep whole milliseconds (yields to other tasks), spin the remainder
+        uint32_t remaining = (uint32_t)(nextDeadline - now);
+        if (remaining > 1000)
+            delay(remaining / 1000);
+        while ((now = nowUs()) < nextDeadline)
+        {
+        }
+    }
+
+    uint64_t lateness = now - nextDeadline;
+    if (lateness >= periodUs)
+    {
+        // Fell behind by whole slots: drop them instead of bursting to catch up
+        st.droppedTicks += (uint32_t)(lateness / periodUs);
+        nextDeadline = now + periodUs;
+    }
+    else
+    {
+        nextDeadline += periodUs;
+    }
+    if (lateness > periodUs / 4)
+        st.lateFrames++;
+
+    return stepTo(now);
+}
+
+const FrameTime &FrameScheduler::stepTo(uint64_t now)
+{
+    float dt = (now - ft.nowUs) / 1000000.0f;
+    if (dt > MAX_DT)
+        dt = MAX_DT;
+
+    ft.nowUs = now;
+    ft.nowMs = (uint32_t)(now / 1000);
+    ft.dt = dt;
+    ft.frame++;
+
+    frameStartUs = now;
+    return ft;
+}
+
+void FrameScheduler::endFrame()
+{
+    uint32_t work = (uint32_t)(nowUs() - frameStartUs);
+    st.frames++;
+    st.lastWorkUs = work;
+    if (work > st.maxWorkUs)
+        st.maxWorkUs = work;
+    if (work > periodUs)
+        st.overruns++;
+}
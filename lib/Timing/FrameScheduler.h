@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+
+// Timing handed to every effect for one frame
+struct FrameTime
+{
+    uint64_t nowUs = 0; // microsecond clock at frame start
+    uint32_t nowMs = 0; // same instant in ms (for timers/periods)
+    float dt = 0.0f;    // seconds since previous frame (clamped)
+    uint32_t frame = 0; // frame counter
+};
+
+// Fixed-rate frame clock.
+// waitForFrame() sleeps until the next slot and returns its timing;
+// endFrame() closes the slot and accounts for the budget.
+class FrameScheduler
+{
+public:
+    explicit FrameScheduler(uint16_t targetFps = 100);
+
+    void begin();
+    void setTargetFps(uint16_t fps);
+    uint16_t targetFps() const { return fps; }
+    uint32_t budgetUs() const { return periodUs; }
+
+    const FrameTime &waitForFrame();
+    void endFrame();
+
+    // Starts a frame at nowUs without waiting (replaying recorded frame
+    // times); waitForFrame() goes through the same arithmetic
+    const FrameTime &stepTo(uint64_t nowUs);
+    const FrameTime &time() const { return ft; }
+
+    struct Stats
+    {
+        uint32_t frames = 0;
+        uint32_t overruns = 0;     // work took longer than the frame budget
+        uint32_t lateFrames = 0;   // frame started more than a quarter period late
+        uint32_t droppedTicks = 0; // whole frame slots skipped to catch up
+        uint32_t lastWorkUs = 0;
+        uint32_t maxWorkUs = 0;
+    };
+
+    const Stats &stats() const { return st; }
+    void resetStats() { st = Stats(); }
+
+    static uint64_t nowUs();
+
+    // dt never exceeds this, so a stall doesn't teleport animations
+    static constexpr float MAX_DT = 0.1f;
+
+private:
+    uint16_t fps;
+    uint32_t periodUs;
+    uint64_t nextDeadline = 0;
+    uint64_t frameStartUs = 0;
+    FrameTime ft;
+    Stats st;
+};
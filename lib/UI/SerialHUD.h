@@ -2,6 +2,12 @@
 #include <Arduino.h>
 #include "LightingParams.h"
 #include "EffectManager.h"
+#include "FrameProfiler.h"
+#include "FrameScheduler.h"
+#include "LedEngine.h"
+#include "AudioInput.h"
+#include "InputManager.h"
+#include "InputLog.h"
 
 class SerialHUD
 {
@@ -59,11 +65,126 @@ public:
         Serial.printf("Sec Color     : H=%3u S=%3u\n", P.secondaryHue(), P.secondarySat());
         Serial.printf("Intensity     : %3u\n", P.intensity());
         Serial.printf("Speed         : %3u\n", P.speed());
+        static const char *tempoSources[] = {"speed", "tap", "audio"};
+        Serial.printf("Tempo         : %.1f BPM (%s)\n", (double)P.beat.bpm(),
+                      tempoSources[(uint8_t)P.beat.source()]);
         Serial.printf("Brightness    : %3u\n", P.brightness);
+        if (P.audio.active)
+            Serial.printf("Audio         : level=%3u bpm=%.1f (conf %u)\n", P.audio.level,
+                          (double)P.audio.bpm, P.audio.confidence);
+        Serial.println("-------------------------------");
+    }
+
+    // Single-key serial commands:
+    //   p = print frame profile, r = reset profile, d = dump input log, h = help
+    void handleCommands(FrameProfiler &prof, FrameScheduler &sched, const LedEngine &leds,
+                        const AudioInput &audio, InputManager &input, const InputLogWriter &log)
+    {
+        while (Serial.available() > 0)
+        {
+            int c = Serial.read();
+            if (c == 'p')
+                printProfile(prof, sched, leds, audio, input, log);
+            else if (c == 'r')
+            {
+                prof.reset();
+                sched.resetStats();
+                input.resetStats();
+                for (uint8_t i = 0; i < input.encoderCount(); i++)
+                    input.encoder(i).resetIsrStats();
+                Serial.println("Profile reset");
+            }
+            else if (c == 'd')
+                dumpInputLog(log);
+            else if (c == 'h' || c == '?')
+                Serial.println("Commands: p=profile r=reset d=dump input log h=help");
+        }
+    }
+
+    // ISR cost in CPU cycles (240 per us at 240 MHz). A PCNT encoder only
+    // has the button interrupt.
+    void printEncoderIsr(uint8_t i, const Encoder &enc)
+    {
+        EncoderIsrStats s = enc.getIsrStats();
+        uint32_t calls = s.abCalls + s.swCalls;
+        Serial.printf("Enc%u ISR %s: ab=%lu sw=%lu avg=%lu max=%lu cyc invalid=%lu\n", i + 1,
+                      enc.getBackend() == EncoderBackend::Pcnt ? "pcnt " : "irq  ",
+                      (unsigned long)s.abCalls, (unsigned long)s.swCalls,
+                      (unsigned long)(calls ? s.cycles / calls : 0), (unsigned long)s.maxCycles,
+                      (unsigned long)s.invalidAB);
+    }
+
+    // Hex lines between two markers; save the serial output to a file and
+    // run it with `bench replay <file>`
+    void dumpInputLog(const InputLogWriter &log)
+    {
+        Serial.printf("\n--- input log %lu bytes, %lu frames ---\n",
+                      (unsigned long)log.size(), (unsigned long)log.frames());
+        const uint8_t *d = log.data();
+        for (size_t i = 0; i < log.size(); i += 32)
+        {
+            char line[66];
+            size_t n = log.size() - i < 32 ? log.size() - i : 32;
+            line[0] = '#';
+            for (size_t j = 0; j < n; j++)
+                sprintf(line + 1 + j * 2, "%02x", d[i + j]);
+            Serial.println(line);
+        }
+        Serial.println("--- end input log ---");
+    }
+
+    void printProfile(const FrameProfiler &prof, const FrameScheduler &sched, const LedEngine &leds,
+                      const AudioInput &audio, const InputManager &input, const InputLogWriter &log)
+    {
+        static const char *stageNames[] = {"Input", "Mapper", "Render", "Blend", "Power", "Dither", "Show"};
+
+        const FrameScheduler::Stats &st = sched.stats();
+        Serial.printf("\n--- Frame Profile (%u frames) ---\n", (unsigned)prof.windowFrames());
+        Serial.printf("Target        : %u FPS (%lu us budget)\n", sched.targetFps(), (unsigned long)sched.budgetUs());
+        Serial.printf("Frames        : %lu  overruns=%lu late=%lu dropped=%lu\n",
+                      (unsigned long)st.frames, (unsigned long)st.overruns,
+                      (unsigned long)st.lateFrames, (unsigned long)st.droppedTicks);
+        Serial.printf("Work          : last=%lu us max=%lu us\n",
+                      (unsigned long)st.lastWorkUs, (unsigned long)st.maxWorkUs);
+        Serial.printf("Output        : shown=%lu skipped=%lu (unchanged)\n",
+                      (unsigned long)leds.framesShown(), (unsigned long)leds.framesSkipped());
+        Serial.printf("Power         : %u mA est. (limiter %u/255)\n",
+                      (unsigned)leds.lastDrawMa(), (unsigned)leds.lastPowerScale());
+        Serial.printf("Audio         : %lu hops, last=%lu us max=%lu us (of %lu us per hop)\n",
+                      (unsigned long)audio.hopsProcessed(), (unsigned long)audio.lastProcessUs(),
+                      (unsigned long)audio.maxProcessUs(), (unsigned long)audio.hopBudgetUs());
+        Serial.printf("Input         : %lu ticks, last=%lu us max=%lu us, max gap=%lu us, dropped=%lu\n",
+                      (unsigned long)input.ticks(), (unsigned long)input.lastSampleUs(),
+                      (unsigned long)input.maxSampleUs(), (unsigned long)input.maxTickGapUs(),
+                      (unsigned long)input.droppedEvents());
+        for (uint8_t i = 0; i < input.encoderCount(); i++)
+            printEncoderIsr(i, input.encoder(i));
+        Serial.printf("Input log     : %lu frames, %lu bytes%s\n",
+                      (unsigned long)log.frames(), (unsigned long)log.size(),
+                      log.full() ? " (full, stopped)" : "");
+
+        Serial.println("Stage            n     min     avg     p99     max (us)");
+        for (uint8_t i = 0; i < (uint8_t)ProfileStage::Count; i++)
+            printHistogram(prof, stageNames[i], prof.stage((ProfileStage)i));
+
+        Serial.println("Effect");
+        for (uint8_t i = 0; i < FrameProfiler::MAX_EFFECTS; i++)
+        {
+            const char *name = prof.effectName(i);
+            if (name && prof.effect(i).count())
+                printHistogram(prof, name, prof.effect(i));
+        }
         Serial.println("-------------------------------");
     }
 
 private:
+    void printHistogram(const FrameProfiler &prof, const char *name, const StageHistogram &h)
+    {
+        Serial.printf("%-12s %6lu %7.1f %7.1f %7.1f %7.1f\n", name, (unsigned long)h.count(),
+                      prof.toUs(h.minCycles()), prof.toUs(h.avgCycles()),
+                      prof.toUs(h.percentile(99)), prof.toUs(h.maxCycles()));
+    }
+
     bool dirty = false;
     uint32_t lastPrint = 0;
 };
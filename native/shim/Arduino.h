@@ -0,0 +1,136 @@
+#pragma once
+// Minimal Arduino API for the host-native build (env:native).
+// Only what lib/Lighting, lib/LedEngine, lib/Timing, lib/Audio,
+// lib/Encoder, lib/Inputs and lib/Show use.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+using std::abs;
+using std::max;
+using std::min;
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define HIGH 0x1
+#define LOW 0x0
+
+// GPIO: no pins on the host; inputs read as idle (pulled up), interrupts
+// never fire
+#define INPUT 0x01
+#define INPUT_PULLUP 0x05
+#define CHANGE 0x03
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+inline void attachInterruptArg(uint8_t, void (*)(void *), void *, int) {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// ADC: reads as 0
+typedef enum
+{
+    ADC_0db,
+    ADC_2_5db,
+    ADC_6db,
+    ADC_11db
+} adc_attenuation_t;
+inline uint16_t analogRead(uint8_t) { return 0; }
+inline void analogReadResolution(uint8_t) {}
+inline void analogSetPinAttenuation(uint8_t, adc_attenuation_t) {}
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline uint64_t nativeMicros64()
+{
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return (uint64_t)duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+inline uint32_t micros() { return (uint32_t)nativeMicros64(); }
+inline uint32_t millis() { return (uint32_t)(nativeMicros64() / 1000); }
+inline void delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void delayMicroseconds(uint32_t us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+inline void yield() {}
+
+// Arduino random(): deterministic per run unless randomSeed() is called
+inline uint32_t &nativeRandomState()
+{
+    static uint32_t state = 0x12345678;
+    return state;
+}
+inline void randomSeed(unsigned long seed) { nativeRandomState() = seed ? (uint32_t)seed : 1; }
+inline long random(long howbig)
+{
+    if (howbig <= 0)
+        return 0;
+    uint32_t &x = nativeRandomState();
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return (long)(x % (uint32_t)howbig);
+}
+inline long random(long howsmall, long howbig)
+{
+    if (howsmall >= howbig)
+        return howsmall;
+    return random(howbig - howsmall) + howsmall;
+}
+
+// Serial → stdout (muted: dropped, e.g. while replaying a show)
+class NativeSerial
+{
+public:
+    bool muted = false;
+
+    void begin(unsigned long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    int printf(const char *fmt, ...)
+    {
+        if (muted)
+            return 0;
+        va_list args;
+        va_start(args, fmt);
+        int n = vprintf(fmt, args);
+        va_end(args);
+        return n;
+    }
+    void print(const char *s)
+    {
+        if (!muted)
+            fputs(s, stdout);
+    }
+    void print(long v)
+    {
+        if (!muted)
+            ::printf("%ld", v);
+    }
+    void println(const char *s = "")
+    {
+        if (!muted)
+            ::printf("%s\n", s);
+    }
+    void println(long v)
+    {
+        if (!muted)
+            ::printf("%ld\n", v);
+    }
+};
+
+inline NativeSerial Serial;
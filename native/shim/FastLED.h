@@ -0,0 +1,232 @@
+#pragma once
+// Minimal FastLED subset for the host-native build (env:native).
+// Math follows FastLED's portable C implementations so benchmark
+// numbers and colours stay representative.
+#include <Arduino.h>
+
+typedef uint8_t fract8;
+
+inline uint8_t scale8(uint8_t i, fract8 scale) { return (uint8_t)(((uint16_t)i * (1 + (uint16_t)scale)) >> 8); }
+inline uint8_t scale8_video(uint8_t i, fract8 scale) { return (uint8_t)((((uint16_t)i * scale) >> 8) + ((i && scale) ? 1 : 0)); }
+inline uint8_t qadd8(uint8_t i, uint8_t j)
+{
+    unsigned t = i + j;
+    return t > 255 ? 255 : (uint8_t)t;
+}
+inline uint8_t qsub8(uint8_t i, uint8_t j) { return i > j ? i - j : 0; }
+inline uint16_t scale16(uint16_t i, uint16_t scale) { return (uint16_t)(((uint32_t)i * (1 + (uint32_t)scale)) >> 16); }
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB)
+{
+    uint16_t partial = (a << 8) | b;
+    partial += (b * amountOfB);
+    partial -= (a * amountOfB);
+    return partial >> 8;
+}
+inline uint8_t lerp8by8(uint8_t a, uint8_t b, fract8 frac)
+{
+    return b > a ? a + scale8(b - a, frac) : a - scale8(a - b, frac);
+}
+
+struct CHSV
+{
+    union
+    {
+        struct
+        {
+            uint8_t h, s, v;
+        };
+        struct
+        {
+            uint8_t hue, sat, val;
+        };
+        uint8_t raw[3];
+    };
+    CHSV() : h(0), s(0), v(0) {}
+    CHSV(uint8_t ih, uint8_t is, uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+struct CRGB;
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb);
+
+struct CRGB
+{
+    union
+    {
+        struct
+        {
+            uint8_t r, g, b;
+        };
+        uint8_t raw[3];
+    };
+
+    enum HTMLColorCode
+    {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Green = 0x008000,
+        Red = 0xFF0000,
+        White = 0xFFFFFF,
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(HTMLColorCode c) : r((c >> 16) & 0xFF), g((c >> 8) & 0xFF), b(c & 0xFF) {}
+    CRGB(const CHSV &hsv) { hsv2rgb_rainbow(hsv, *this); }
+
+    CRGB &operator=(const CHSV &hsv)
+    {
+        hsv2rgb_rainbow(hsv, *this);
+        return *this;
+    }
+
+    uint8_t &operator[](uint8_t x) { return raw[x]; }
+    const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+
+    CRGB &nscale8(uint8_t scale)
+    {
+        r = scale8(r, scale);
+        g = scale8(g, scale);
+        b = scale8(b, scale);
+        return *this;
+    }
+    CRGB &nscale8_video(uint8_t scale)
+    {
+        r = scale8_video(r, scale);
+        g = scale8_video(g, scale);
+        b = scale8_video(b, scale);
+        return *this;
+    }
+    CRGB &operator+=(const CRGB &o)
+    {
+        r = qadd8(r, o.r);
+        g = qadd8(g, o.g);
+        b = qadd8(b, o.b);
+        return *this;
+    }
+
+    explicit operator bool() const { return r || g || b; }
+    bool operator==(const CRGB &o) const { return r == o.r && g == o.g && b == o.b; }
+    bool operator!=(const CRGB &o) const { return !(*this == o); }
+};
+
+// FastLED "rainbow" hue mapping (yellow boosted, no gamma)
+inline void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb)
+{
+    uint8_t hue = hsv.hue, sat = hsv.sat, val = hsv.val;
+    uint8_t offset8 = (hue & 0x1F) << 3;
+    uint8_t third = scale8(offset8, 256 / 3);
+    uint8_t twothirds = scale8(offset8, (256 * 2) / 3);
+    uint8_t r, g, b;
+
+    if (!(hue & 0x80))
+    {
+        if (!(hue & 0x40))
+        {
+            if (!(hue & 0x20))
+            {
+                r = 255 - third; g = third; b = 0; // R -> O
+            }
+            else
+            {
+                r = 171; g = 85 + third; b = 0; // O -> Y
+            }
+        }
+        else
+        {
+            if (!(hue & 0x20))
+            {
+                r = 171 - twothirds; g = 170 + third; b = 0; // Y -> G
+            }
+            else
+            {
+                r = 0; g = 255 - third; b = third; // G -> A
+            }
+        }
+    }
+    else
+    {
+        if (!(hue & 0x40))
+        {
+            if (!(hue & 0x20))
+            {
+                r = 0; g = 171 - twothirds; b = 85 + twothirds; // A -> B
+            }
+            else
+            {
+                r = third; g = 0; b = 255 - third; // B -> P
+            }
+        }
+        else
+        {
+            if (!(hue & 0x20))
+            {
+                r = 85 + third; g = 0; b = 171 - third; // P -> K
+            }
+            else
+            {
+                r = 170 + third; g = 0; b = 85 - third; // K -> R
+            }
+        }
+    }
+
+    if (sat != 255)
+    {
+        if (sat == 0)
+        {
+            r = g = b = 255;
+        }
+        else
+        {
+            uint8_t desat = 255 - sat;
+            desat = scale8(desat, desat);
+            uint8_t satscale = 255 - desat;
+            r = scale8(r, satscale) + desat;
+            g = scale8(g, satscale) + desat;
+            b = scale8(b, satscale) + desat;
+        }
+    }
+
+    if (val != 255)
+    {
+        val = scale8_video(val, val);
+        r = scale8(r, val);
+        g = scale8(g, val);
+        b = scale8(b, val);
+    }
+
+    rgb.r = r;
+    rgb.g = g;
+    rgb.b = b;
+}
+
+inline CRGB &nblend(CRGB &existing, const CRGB &overlay, fract8 amountOfOverlay)
+{
+    existing.r = blend8(existing.r, overlay.r, amountOfOverlay);
+    existing.g = blend8(existing.g, overlay.g, amountOfOverlay);
+    existing.b = blend8(existing.b, overlay.b, amountOfOverlay);
+    return existing;
+}
+
+inline CRGB blend(const CRGB &p1, const CRGB &p2, fract8 amountOfP2)
+{
+    CRGB nu(p1);
+    nblend(nu, p2, amountOfP2);
+    return nu;
+}
+
+inline void fill_solid(CRGB *leds, int numToFill, const CRGB &color)
+{
+    for (int i = 0; i < numToFill; ++i)
+        leds[i] = color;
+}
+
+// WS2812B colour-order tags (only used as template arguments on device)
+enum EOrder
+{
+    RGB = 0012,
+    GRB = 0102,
+    BRG = 0201,
+};
+
+// Output controllers only exist on device; host code sees an opaque type
+class CLEDController;
@@ -0,0 +1,63 @@
+#pragma once
+// In-memory stand-in for the ESP32 NVS Preferences API (env:native).
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class Preferences
+{
+public:
+    bool begin(const char *name, bool readOnly = false)
+    {
+        ns = name;
+        return true;
+    }
+    void end() {}
+
+    bool isKey(const char *key) { return store().count(full(key)) != 0; }
+    bool remove(const char *key) { return store().erase(full(key)) != 0; }
+
+    size_t putUChar(const char *key, uint8_t value) { return putBytes(key, &value, 1); }
+    size_t putBool(const char *key, bool value) { return putUChar(key, value ? 1 : 0); }
+    size_t putBytes(const char *key, const void *value, size_t len)
+    {
+        const uint8_t *p = static_cast<const uint8_t *>(value);
+        store()[full(key)].assign(p, p + len);
+        return len;
+    }
+
+    uint8_t getUChar(const char *key, uint8_t defaultValue = 0)
+    {
+        uint8_t v = defaultValue;
+        getBytes(key, &v, 1);
+        return v;
+    }
+    bool getBool(const char *key, bool defaultValue = false) { return getUChar(key, defaultValue ? 1 : 0) != 0; }
+    size_t getBytesLength(const char *key)
+    {
+        auto it = store().find(full(key));
+        return it == store().end() ? 0 : it->second.size();
+    }
+    size_t getBytes(const char *key, void *buf, size_t maxLen)
+    {
+        auto it = store().find(full(key));
+        if (it == store().end() || it->second.size() > maxLen)
+            return 0;
+        memcpy(buf, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+
+private:
+    std::string ns;
+
+    std::string full(const char *key) const { return ns + "/" + key; }
+
+    // Shared across instances, like the real flash partition
+    static std::map<std::string, std::vector<uint8_t>> &store()
+    {
+        static std::map<std::string, std::vector<uint8_t>> s;
+        return s;
+    }
+};
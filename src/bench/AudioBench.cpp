@@ -0,0 +1,118 @@
+// Audio pipeline cost and tempo check: a WAV file (or, without one, a
+// synthetic 128 BPM kick/hat loop) fed hop by hop through AudioAnalyzer,
+// the same code the capture task runs on the device
+#include <Arduino.h>
+#include <vector>
+#include "Bench.h"
+#include "AudioAnalyzer.h"
+#include "AudioSource.h"
+#include "FastRandom.h"
+
+static const float AB_SYNTH_BPM = 128.0f;
+static const uint32_t AB_SYNTH_SECONDS = 20;
+
+// Kick on every beat, hat on the off-beats, noise underneath
+static std::vector<int16_t> synthLoop(uint32_t rate)
+{
+    std::vector<int16_t> pcm(rate * AB_SYNTH_SECONDS);
+    uint32_t beat = (uint32_t)(rate * 60.0f / AB_SYNTH_BPM);
+    FastRandom rng(7);
+
+    for (uint32_t i = 0; i < pcm.size(); i++)
+    {
+        float t = (float)(i % beat) / rate;
+        float s = 0.6f * expf(-t * 30.0f) * sinf(6.2831853f * (55.0f + 90.0f * expf(-t * 40.0f)) * t);
+
+        float ht = (float)((i + beat / 2) % beat) / rate;
+        float noise = ((int32_t)(rng.next() >> 16) - 32768) / 32768.0f;
+        s += 0.15f * expf(-ht * 120.0f) * noise + 0.01f * noise;
+
+        pcm[i] = (int16_t)(s * 32767.0f);
+    }
+    return pcm;
+}
+
+// Whole file, boxcar-decimated to roughly the device rate so the
+// analyzer runs with the same bin and tempo resolution
+static bool loadWav(const char *path, std::vector<int16_t> &pcm, uint32_t &rate)
+{
+    WavAudioSource src(path);
+    if (!src.begin(AUDIO_SAMPLE_RATE))
+        return false;
+
+    std::vector<int16_t> in;
+    int16_t buf[1024];
+    size_t got;
+    while ((got = src.read(buf, 1024)) > 0)
+        in.insert(in.end(), buf, buf + got);
+
+    uint32_t factor = (src.sampleRate() + AUDIO_SAMPLE_RATE / 2) / AUDIO_SAMPLE_RATE;
+    if (factor < 1)
+        factor = 1;
+    rate = src.sampleRate() / factor;
+    pcm.resize(in.size() / factor);
+    for (size_t i = 0; i < pcm.size(); i++)
+    {
+        int32_t sum = 0;
+        for (uint32_t k = 0; k < factor; k++)
+            sum += in[i * factor + k];
+        pcm[i] = (int16_t)(sum / (int32_t)factor);
+    }
+    return true;
+}
+
+void benchAudio(const char *wavPath)
+{
+    std::vector<int16_t> pcm;
+    uint32_t rate = AUDIO_SAMPLE_RATE;
+
+    printf("\nAudio pipeline (%u-pt FFT, %u-sample hop, %u bands)\n",
+           1u << AUDIO_FFT_LOG2, AUDIO_HOP, AUDIO_BANDS);
+    if (wavPath)
+    {
+        if (!loadWav(wavPath, pcm, rate))
+        {
+            printf("  can't read %s (16-bit PCM WAV, mono or stereo)\n", wavPath);
+            return;
+        }
+        printf("  input: %s, %.1f s at %u Hz\n", wavPath, (double)pcm.size() / rate, (unsigned)rate);
+    }
+    else
+    {
+        pcm = synthLoop(rate);
+        printf("  input: synthetic %.0f BPM loop, %u s at %u Hz\n", AB_SYNTH_BPM,
+               (unsigned)AB_SYNTH_SECONDS, (unsigned)rate);
+    }
+
+    AudioAnalyzer an;
+    an.begin(rate);
+
+    size_t hops = pcm.size() / AUDIO_HOP;
+    double total = 0.0, worst = 0.0;
+    uint32_t bandSum[AUDIO_BANDS] = {};
+    for (size_t h = 0; h < hops; h++)
+    {
+        uint32_t audioMs = (uint32_t)((uint64_t)(h + 1) * AUDIO_HOP * 1000 / rate);
+        double t0 = benchNowNs();
+        an.process(&pcm[h * AUDIO_HOP], audioMs);
+        double ns = benchNowNs() - t0;
+        total += ns;
+        if (ns > worst)
+            worst = ns;
+        for (uint8_t b = 0; b < AUDIO_BANDS; b++)
+            bandSum[b] += an.features().bands[b];
+    }
+    if (!hops)
+        return;
+
+    const AudioFeatures &f = an.features();
+    double hopNs = 1e9 * AUDIO_HOP / rate;
+    printf("  %zu hops: %.0f ns/hop avg, %.0f max (%.3f%% of the %.1f ms hop)\n",
+           hops, total / hops, worst, 100.0 * total / hops / hopNs, hopNs / 1e6);
+    printf("  onsets=%u (%.1f/s)  bpm=%.1f  confidence=%u\n", (unsigned)f.onsetCount,
+           f.onsetCount / ((double)pcm.size() / rate), (double)f.bpm, (unsigned)f.confidence);
+    printf("  mean band level:");
+    for (uint8_t b = 0; b < AUDIO_BANDS; b++)
+        printf(" %uHz=%u", an.bandLowHz(b), (unsigned)(bandSum[b] / hops));
+    printf("\n");
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <stdint.h>
+#include <chrono>
+
+// Shared helpers for the host benchmark (env:native)
+
+inline double benchNowNs()
+{
+    using namespace std::chrono;
+    return (double)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Keeps the optimiser from discarding benchmarked results
+template <typename T>
+inline void benchKeep(const T &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// False when a FixedMath.h error bound is exceeded
+bool benchFixedMath();
+void benchCrossfade(uint32_t frames);
+void benchParticles();
+void benchAudio(const char *wavPath);
+void benchEncoder();
+// False on a checksum mismatch, a damaged log or one that can't be read
+bool benchReplay(const char *logPath);
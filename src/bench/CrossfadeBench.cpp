@@ -0,0 +1,97 @@
+// Worst-case crossfade frame: both effects rendering plus the blend
+#include <Arduino.h>
+#include <vector>
+#include "Bench.h"
+#include "EffectManager.h"
+#include "SpatialWaveEffect.h"
+#include "DoubleHelixEffect.h"
+#include "SphereEffect.h"
+#include "RainEffect.h"
+
+static const uint16_t XF_LED_COUNTS[] = {240, 480, 960};
+static const uint8_t XF_MAIN_LEDS = 2;
+
+// ns/frame for fx over frames; a long crossfade keeps every frame dual-render
+static double timeFrames(EffectManager &fx, LightingParams &P, const SpatialMap &map,
+                         CRGB *mainLeds, CRGB *detailLeds, uint16_t nDetail,
+                         uint32_t &nowMs, uint32_t frames)
+{
+    double t0 = benchNowNs();
+    for (uint32_t f = 0; f < frames; f++, nowMs += 10)
+    {
+        P.beat.update(0.01f);
+        fx.render(P, map, mainLeds, XF_MAIN_LEDS, detailLeds, nDetail, nowMs, 0.01f);
+    }
+    return (benchNowNs() - t0) / frames;
+}
+
+void benchCrossfade(uint32_t frames)
+{
+    printf("\nCrossfade (EffectManager), 100 FPS budget = 10000000 ns\n");
+    printf("%-14s %5s %12s %12s %12s\n", "worst pair", "leds", "single ns", "fade ns", "fade/budget");
+
+    for (uint16_t nDetail : XF_LED_COUNTS)
+    {
+        SpatialMap map(nDetail, 8, 5.0f, 3.0f, true);
+        map.begin();
+        std::vector<CRGB> detail(nDetail);
+        CRGB mainLeds[XF_MAIN_LEDS];
+
+        SpatialWaveEffect wave;
+        DoubleHelixEffect helix;
+        SphereEffect sphere;
+        RainEffect rain;
+
+        EffectManager fx;
+        fx.begin(XF_MAIN_LEDS, nDetail);
+        fx.setCrossfadeMs(60000);
+        fx.add(&wave, "Wave");
+        fx.add(&helix, "Helix");
+        fx.add(&sphere, "Sphere");
+        fx.add(&rain, "Rain");
+
+        EffectConfig cfg;
+        cfg.speed = 255;
+        cfg.intensity = 255;
+        LightingParams P;
+        P.activeConfig = &cfg;
+        P.beat.setSpeed(cfg.speed);
+
+        uint32_t nowMs = 1;
+        double worstSingle = 0.0, worstFade = 0.0;
+        uint8_t worstFrom = 0, worstTo = 0;
+
+        for (uint8_t from = 0; from < fx.count(); from++)
+        {
+            fx.setCrossfadeMs(0);
+            fx.setEffect(from);
+            double single = timeFrames(fx, P, map, mainLeds, detail.data(), nDetail, nowMs, frames);
+            if (single > worstSingle)
+                worstSingle = single;
+
+            for (uint8_t to = 0; to < fx.count(); to++)
+            {
+                if (to == from)
+                    continue;
+                fx.setCrossfadeMs(0);
+                fx.setEffect(from);
+                fx.render(P, map, mainLeds, XF_MAIN_LEDS, detail.data(), nDetail, nowMs, 0.01f);
+                fx.setCrossfadeMs(60000);
+                fx.setEffect(to);
+
+                double fade = timeFrames(fx, P, map, mainLeds, detail.data(), nDetail, nowMs, frames);
+                if (fade > worstFade)
+                {
+                    worstFade = fade;
+                    worstFrom = from;
+                    worstTo = to;
+                }
+            }
+        }
+
+        char pair[32];
+        snprintf(pair, sizeof(pair), "%s>%s", fx.nameOf(worstFrom), fx.nameOf(worstTo));
+        printf("%-14s %5u %12.0f %12.0f %11.2f%%\n", pair, nDetail, worstSingle, worstFade,
+               worstFade / 100000.0);
+    }
+}
@@ -0,0 +1,63 @@
+// Encoder quadrature through the PCNT mock: a long random spin with
+// contact glitches must count exactly, and costs a handful of limit
+// interrupts where the GPIO backend takes one interrupt per edge
+#include <Arduino.h>
+#include "Bench.h"
+#include "PcntUnit.h"
+#include "FastRandom.h"
+
+static const uint32_t EB_STEPS = 1000000;
+static const uint32_t EB_STEP_NS = 250000; // 4000 steps/s, a very fast spin
+static const uint32_t EB_GLITCH_NS = 2000; // chatter, well inside the filter
+static const uint8_t EB_GLITCH_PCT = 5;
+
+// Levels (A<<1 | B) in the +1 direction, matching Encoder's QTAB
+static const uint8_t EB_GRAY[4] = {0b00, 0b10, 0b11, 0b01};
+
+void benchEncoder()
+{
+    PcntUnit unit;
+    if (!unit.begin(0, 1))
+    {
+        printf("\nEncoder: no PCNT unit left\n");
+        return;
+    }
+
+    FastRandom rng(3);
+    uint8_t phase = 2; // 11: idle, both pulled up
+    int32_t expected = 0;
+    int8_t dir = 1;
+    uint32_t run = 0;
+    uint32_t edges = 0;
+
+    for (uint32_t s = 0; s < EB_STEPS; s++)
+    {
+        if (run == 0)
+        {
+            dir = rng.chance(60) ? 1 : -1; // drifts up, past the counter limits
+            run = 1 + rng.below(400);
+        }
+        run--;
+
+        phase = (phase + dir) & 3;
+        expected += dir;
+        uint8_t lv = EB_GRAY[phase];
+        unit.mockInput(lv & 2, lv & 1, EB_STEP_NS);
+        edges++;
+
+        // A glitch on one line that snaps back
+        if (rng.chance(EB_GLITCH_PCT))
+        {
+            uint8_t g = lv ^ (rng.chance(50) ? 2 : 1);
+            unit.mockInput(g & 2, g & 1, EB_GLITCH_NS);
+            unit.mockInput(lv & 2, lv & 1, EB_STEP_NS);
+            edges += 2;
+        }
+    }
+
+    printf("\nEncoder (PCNT mock), %u steps with %u%% glitches\n", (unsigned)EB_STEPS, EB_GLITCH_PCT);
+    printf("  count %ld, expected %ld -> %s\n", (long)unit.read(), (long)expected,
+           unit.read() == expected ? "exact" : "MISMATCH");
+    printf("  interrupts: GPIO backend %u (one per edge), PCNT %u (limit events)\n",
+           (unsigned)edges, (unsigned)unit.limitEvents());
+}
@@ -0,0 +1,100 @@
+// Accuracy and speed of lib/Lighting/FixedMath.h against libm. The
+// accuracy checks fail when an error bound documented there is exceeded.
+#include <Arduino.h>
+#include "Bench.h"
+#include "FixedMath.h"
+
+static bool sinAccuracy()
+{
+    double maxErr = 0.0;
+    for (uint32_t a = 0; a < 65536; a++)
+    {
+        double ref = sin(a * (2.0 * M_PI / 65536.0));
+        double err = fabs(fxSin((uint16_t)a) / 32767.0 - ref);
+        if (err > maxErr)
+            maxErr = err;
+    }
+    bool ok = maxErr * 32767.0 <= FX_SIN_MAX_ERR_LSB;
+    printf("fxSin     max |err| = %.2e (%.1f LSB Q15, bound %.0f) %s\n", maxErr, maxErr * 32767.0,
+           FX_SIN_MAX_ERR_LSB, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+static bool atan2Accuracy()
+{
+    double maxErr = 0.0;
+    for (int32_t y = -2000; y <= 2000; y += 7)
+    {
+        for (int32_t x = -2000; x <= 2000; x += 7)
+        {
+            if (x == 0 && y == 0)
+                continue;
+            double ref = atan2((double)y, (double)x) * (65536.0 / (2.0 * M_PI));
+            double got = (int16_t)fxAtan2(y, x); // signed view: -32768..32767
+            double err = fabs(got - ref);
+            if (err > 32768.0)
+                err = 65536.0 - err;
+            if (err > maxErr)
+                maxErr = err;
+        }
+    }
+    bool ok = maxErr <= FX_ATAN2_MAX_ERR_TURNS;
+    printf("fxAtan2   max |err| = %.1f turn units (%.3f deg, bound %.0f) %s\n", maxErr,
+           maxErr * 360.0 / 65536.0, FX_ATAN2_MAX_ERR_TURNS, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+static bool sqrtAccuracy()
+{
+    uint32_t bad = 0;
+    for (uint32_t v = 0; v < 2000000; v += 3)
+    {
+        uint32_t r = fxSqrt32(v);
+        if ((uint64_t)r * r > v || (uint64_t)(r + 1) * (r + 1) <= v)
+            bad++;
+    }
+    for (uint32_t v = 0xFFFF0000u; v != 0 && v >= 0xFFFF0000u; v += 97)
+    {
+        uint32_t r = fxSqrt32(v);
+        if ((uint64_t)r * r > v || (uint64_t)(r + 1) * (r + 1) <= v)
+            bad++;
+    }
+    printf("fxSqrt32  floor mismatches = %u %s\n", (unsigned)bad, bad ? "FAIL" : "ok");
+    return bad == 0;
+}
+
+template <typename F>
+static double timeNs(uint32_t n, F fn)
+{
+    double t0 = benchNowNs();
+    for (uint32_t i = 0; i < n; i++)
+        fn(i);
+    return (benchNowNs() - t0) / n;
+}
+
+bool benchFixedMath()
+{
+    printf("\nFixed-point kernels (lib/Lighting/FixedMath.h)\n");
+    bool ok = sinAccuracy();
+    ok &= atan2Accuracy();
+    ok &= sqrtAccuracy();
+
+    const uint32_t N = 2000000;
+    volatile int32_t sink = 0;
+
+    double fx = timeNs(N, [&](uint32_t i) { sink += fxSin((uint16_t)(i * 2654435761u)); });
+    double lf = timeNs(N, [&](uint32_t i) { sink += (int32_t)(sinf((i & 0xFFFF) * 9.58738e-5f) * 32767.0f); });
+    double ld = timeNs(N, [&](uint32_t i) { sink += (int32_t)(sin((i & 0xFFFF) * 9.58738e-5) * 32767.0); });
+    printf("sin       fx %.2f ns   sinf %.2f ns   sin(double) %.2f ns\n", fx, lf, ld);
+
+    fx = timeNs(N, [&](uint32_t i) { sink += fxAtan2((int32_t)(i & 1023) - 512, (int32_t)((i >> 10) & 1023) - 512); });
+    lf = timeNs(N, [&](uint32_t i) { sink += (int32_t)atan2f((float)((int32_t)(i & 1023) - 512), (float)((int32_t)((i >> 10) & 1023) - 512)); });
+    printf("atan2     fx %.2f ns   atan2f %.2f ns\n", fx, lf);
+
+    fx = timeNs(N, [&](uint32_t i) { sink += fxSqrt32(i * 977u); });
+    lf = timeNs(N, [&](uint32_t i) { sink += (int32_t)sqrtf((float)(i * 977u)); });
+    printf("sqrt      fx %.2f ns   sqrtf %.2f ns\n", fx, lf);
+
+    benchKeep(sink);
+    return ok;
+}
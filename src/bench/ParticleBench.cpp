@@ -0,0 +1,123 @@
+// ParticleSystem vs. the fixed-array scan it replaced, at 1x and 10x the
+// Rain/EnergyBurst particle counts
+#include <Arduino.h>
+#include <vector>
+#include "Bench.h"
+#include "ParticleSystem.h"
+#include "FastRandom.h"
+
+static const uint16_t PB_LEDS = 240;
+static const uint32_t PB_FRAMES = 2000;
+static const int32_t PB_DT_Q16 = 655; // 10 ms
+
+// Old pattern: linear scan to find a free slot, scan everything to update
+struct ScanParticle
+{
+    int32_t pos;
+    uint8_t string;
+    bool active = false;
+};
+
+static double runScan(const SpatialMap &map, uint16_t cap, uint16_t spawnPerFrame, CRGB *leds)
+{
+    std::vector<ScanParticle> ps(cap);
+    FastRandom rng(1);
+    const uint8_t strings = map.stringCount();
+
+    double t0 = benchNowNs();
+    for (uint32_t f = 0; f < PB_FRAMES; f++)
+    {
+        for (uint16_t s = 0; s < spawnPerFrame; s++)
+        {
+            for (uint16_t i = 0; i < cap; i++)
+            {
+                if (!ps[i].active)
+                {
+                    ps[i].pos = 65536;
+                    ps[i].string = rng.below(strings);
+                    ps[i].active = true;
+                    break;
+                }
+            }
+        }
+        for (uint16_t i = 0; i < cap; i++)
+        {
+            if (!ps[i].active)
+                continue;
+            ps[i].pos -= 1311 + (i & 7) * 64; // ~0.5-0.8 s lifetime
+            if (ps[i].pos <= 0)
+            {
+                ps[i].active = false;
+                continue;
+            }
+            leds[map.ledAtHeightQ16(ps[i].string, ps[i].pos)] = CRGB::White;
+        }
+    }
+    benchKeep(leds[0]);
+    return (benchNowNs() - t0) / PB_FRAMES;
+}
+
+static double runPool(const SpatialMap &map, uint16_t cap, uint16_t spawnPerFrame, CRGB *leds)
+{
+    ParticleSystem ps;
+    ps.begin(cap);
+    FastRandom rng(1);
+    const uint8_t strings = map.stringCount();
+
+    double t0 = benchNowNs();
+    for (uint32_t f = 0; f < PB_FRAMES; f++)
+    {
+        for (uint16_t s = 0; s < spawnPerFrame; s++)
+        {
+            ParticleSystem::Particle *p = ps.spawn();
+            if (!p)
+                break;
+            p->pos = 65536;
+            p->string = rng.below(strings);
+            p->vel = -(131100 + (int32_t)(f & 7) * 6400); // per second
+        }
+        ps.integrate(PB_DT_Q16);
+        for (uint16_t k = 0; k < ps.count();)
+        {
+            ParticleSystem::Particle &p = ps.at(k);
+            if (p.pos <= 0)
+            {
+                ps.killAt(k);
+                continue;
+            }
+            leds[ParticleSystem::ledOf(p, map)] = CRGB::White;
+            k++;
+        }
+    }
+    benchKeep(leds[0]);
+    return (benchNowNs() - t0) / PB_FRAMES;
+}
+
+void benchParticles()
+{
+    printf("\nParticles (lib/Lighting/ParticleSystem.h), %u LEDs\n", PB_LEDS);
+    printf("%-12s %6s %6s %12s %12s\n", "load", "cap", "spawn", "scan ns", "pool ns");
+
+    SpatialMap map(PB_LEDS, 8, 5.0f, 3.0f, true);
+    map.begin();
+    std::vector<CRGB> leds(PB_LEDS);
+
+    struct
+    {
+        const char *name;
+        uint16_t cap;
+        uint16_t spawn;
+    } loads[] = {
+        {"Rain 1x", 64, 1},
+        {"Rain 10x", 640, 10},
+        {"Burst 1x", 32, 1},
+        {"Burst 10x", 320, 10},
+    };
+
+    for (auto &l : loads)
+    {
+        double scan = runScan(map, l.cap, l.spawn, leds.data());
+        double pool = runPool(map, l.cap, l.spawn, leds.data());
+        printf("%-12s %6u %6u %12.0f %12.0f\n", l.name, l.cap, l.spawn, scan, pool);
+    }
+}
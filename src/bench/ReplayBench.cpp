@@ -0,0 +1,273 @@
+// Show replay: an input log (the HUD's 'd' dump, or without one a scripted
+// show recorded here first) run through ShowController frame by frame, as
+// fast as it renders. Every checksum in the log has to match, then the
+// slowest frames are listed with what the show was doing in them.
+#include <Arduino.h>
+#include <FastLED.h>
+#include <vector>
+#include "Bench.h"
+#include "InputLog.h"
+#include "ShowController.h"
+#include "FastRandom.h"
+
+// Same geometry as src/main.cpp
+#define RB_LED_STRING_SPACING_CM 3.0f
+#define RB_DISC_LED_STRING_COUNT 8
+#define RB_DISC_RADIUS_CM 5.0f
+
+static const uint16_t RB_MAIN_LEDS = 2;
+static const uint16_t RB_DETAIL_LEDS = 240;
+static const uint32_t RB_SYNTH_FRAMES = 6000; // 60 s at 100 FPS
+static const uint32_t RB_SYNTH_SEED = 0xC0FFEE;
+static const uint8_t RB_SLOWEST = 5;
+
+static const char *RB_MODE_NAMES[] = {"Default", "Strobe", "EnergyBurst", "Emergency"};
+
+// One show as loop() runs it, minus the hardware
+struct ReplayRig
+{
+    ConfigManager configs;
+    LightingParams P;
+    ShowController show;
+    SpatialMap map;
+    std::vector<CRGB> mainLeds, detailLeds;
+    FrameScheduler scheduler;
+
+    ReplayRig(const InputLogHeader &h)
+        : show(P, configs),
+          map(h.detailCount, RB_DISC_LED_STRING_COUNT, RB_DISC_RADIUS_CM, RB_LED_STRING_SPACING_CM, true),
+          mainLeds(h.mainCount), detailLeds(h.detailCount)
+    {
+        map.begin();
+        configs.begin();
+        show.begin(h.mainCount, h.detailCount);
+        show.seed(h.seed);
+        P.beat.setRange(h.minBpm, h.maxBpm);
+        scheduler.stepTo(h.startUs);
+    }
+
+    void frame(const FrameTime &ft, const InputEvent *events, uint8_t count, const AudioFeatures &audio)
+    {
+        P.audio = audio;
+        for (uint8_t i = 0; i < count; i++)
+            show.handleInput(events[i], ft.nowMs);
+        show.update(ft);
+        show.render(map, mainLeds.data(), mainLeds.size(), detailLeds.data(), detailLeds.size(), ft);
+    }
+
+    uint32_t hash() const
+    {
+        return inputLogHash(mainLeds.data(), mainLeds.size(), detailLeds.data(), detailLeds.size());
+    }
+};
+
+// Events the scripted show sends in frame f: knob turns all the time, and
+// every mode, the effect and scene navigator, tap tempo and a save in turn
+static uint8_t scriptedEvents(uint32_t f, uint32_t nowMs, InputEvent *out)
+{
+    uint8_t n = 0;
+    auto ev = [&](InputAction a, int v, uint32_t ageMs = 0) { out[n++] = {a, v, nowMs - ageMs}; };
+
+    if (f % 37 == 5)
+        ev(InputAction::MainHueAdjust, 3);
+    if (f % 53 == 11)
+        ev(InputAction::SecondaryHueAdjust, -5);
+    if (f % 400 == 150)
+        ev(InputAction::IntensityAdjust, (f / 400) % 2 ? 40 : -40);
+    if (f % 450 == 300)
+        ev(InputAction::SpeedAdjust, 25);
+    if (f % 500 == 100)
+        ev(InputAction::EffectAdjust, 1);
+    if (f % 640 == 320)
+        ev(InputAction::ToggleSecondaryColor, 0);
+    if (f % 700 == 200)
+        ev(InputAction::EnterSpecial1, 0);
+    if (f % 700 == 230)
+        ev(InputAction::ExitSpecial1, 0);
+    if (f % 900 == 450)
+        ev(InputAction::EnterSpecial3, 0);
+    if (f % 900 == 510)
+        ev(InputAction::ExitSpecial3, 0);
+    if (f >= 1500 && f < 1600 && f % 20 == 0)
+        ev(InputAction::IntensityAdjust, 60);
+    if (f == 1500 || f == 1700)
+        ev(InputAction::EnterSpecial2, 0);
+    if (f >= 2000 && f < 2200 && f % 50 == 0)
+        ev(InputAction::TapTempo, 1, 80 + f % 7); // clicked: stamped at the press
+    if (f == 3000 || f == 3100)
+        ev(InputAction::SceneStep, 1);
+    if (f == 3400)
+        ev(InputAction::SceneStep, -2);
+    if (f % 300 == 17)
+        ev(InputAction::BrightnessDirect, 60 + (f * 7) % 190);
+    if (f == 5000)
+        ev(InputAction::SaveConfigs, 0);
+    return n;
+}
+
+// Records the scripted show with ~±0.3 ms frame jitter and a few stalls;
+// from frame 4000 on the audio locks to 128 BPM
+static void recordSynthetic(std::vector<uint8_t> &out)
+{
+    InputLogHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "TLOG", 4);
+    h.version = INPUT_LOG_VERSION;
+    h.mainCount = RB_MAIN_LEDS;
+    h.detailCount = RB_DETAIL_LEDS;
+    h.seed = RB_SYNTH_SEED;
+    h.startUs = 5000000; // after a 5 s boot
+    h.minBpm = 50.0f;
+    h.maxBpm = 180.0f;
+
+    ReplayRig rig(h);
+    h.periodUs = rig.scheduler.budgetUs();
+    rig.configs.exportSnapshot(h.config);
+
+    InputLogWriter log;
+    log.begin(h, 1 << 20);
+
+    FastRandom rng(11);
+    AudioFeatures audio;
+    uint64_t t = h.startUs;
+    for (uint32_t f = 0; f < RB_SYNTH_FRAMES; f++)
+    {
+        t += h.periodUs + rng.below(600) - 300;
+        if (f % 997 == 500)
+            t += 25000;
+        const FrameTime &ft = rig.scheduler.stepTo(t);
+
+        if (f >= 4000)
+        {
+            audio.active = true;
+            audio.bpm = 128.0f;
+            audio.confidence = 200;
+            if (f % 47 == 0)
+            {
+                audio.onsetCount++;
+                audio.lastOnsetMs = ft.nowMs;
+            }
+        }
+
+        InputEvent events[INPUT_LOG_MAX_EVENTS];
+        uint8_t count = scriptedEvents(f, ft.nowMs, events);
+        rig.frame(ft, events, count, audio);
+        log.frame(ft, events, count, audio, rig.mainLeds.data(), rig.mainLeds.size(),
+                  rig.detailLeds.data(), rig.detailLeds.size());
+    }
+    out.assign(log.data(), log.data() + log.size());
+}
+
+static bool readFile(const char *path, std::vector<uint8_t> &out)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+    uint8_t buf[4096];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof(buf), f)) > 0)
+        out.insert(out.end(), buf, buf + got);
+    fclose(f);
+    return true;
+}
+
+struct SlowFrame
+{
+    uint32_t index = 0;
+    uint64_t nowUs = 0;
+    double ns = 0.0;
+    uint8_t effectID = 0;
+    ConfigMode mode = ConfigMode::Default;
+};
+
+bool benchReplay(const char *logPath)
+{
+    std::vector<uint8_t> bytes;
+    printf("\nShow replay\n");
+    if (logPath)
+    {
+        if (!readFile(logPath, bytes))
+        {
+            printf("  can't read %s\n", logPath);
+            return false;
+        }
+    }
+    else
+    {
+        Serial.muted = true;
+        recordSynthetic(bytes);
+        Serial.muted = false;
+    }
+
+    InputLogReader reader;
+    if (!reader.load(bytes.data(), bytes.size()))
+    {
+        printf("  not an input log (v%u raw bytes or a HUD 'd' dump)\n", INPUT_LOG_VERSION);
+        return false;
+    }
+    const InputLogHeader &h = reader.header();
+    printf("  %s: %u bytes, %u+%u LEDs, seed %08lx\n", logPath ? logPath : "scripted show",
+           (unsigned)bytes.size(), h.mainCount, h.detailCount, (unsigned long)h.seed);
+
+    // Replay from the configs the recording started with
+    Serial.muted = true;
+    ConfigManager().importSnapshot(h.config);
+    ReplayRig rig(h);
+
+    InputLogFrame f;
+    AudioFeatures audio;
+    SlowFrame slowest[RB_SLOWEST];
+    uint32_t frames = 0, events = 0, hashes = 0;
+    int64_t firstMismatch = -1;
+    double totalNs = 0.0;
+
+    while (reader.next(f, audio))
+    {
+        double t0 = benchNowNs();
+        const FrameTime &ft = rig.scheduler.stepTo(f.nowUs);
+        rig.frame(ft, f.events, f.eventCount, audio);
+        double ns = benchNowNs() - t0;
+
+        totalNs += ns;
+        events += f.eventCount;
+        if (f.hasHash)
+        {
+            hashes++;
+            if (firstMismatch < 0 && rig.hash() != f.hash)
+                firstMismatch = frames;
+        }
+
+        // Keep the slowest few, slowest first
+        for (uint8_t i = 0; i < RB_SLOWEST; i++)
+        {
+            if (ns > slowest[i].ns)
+            {
+                for (uint8_t j = RB_SLOWEST - 1; j > i; j--)
+                    slowest[j] = slowest[j - 1];
+                slowest[i] = {frames, f.nowUs, ns, rig.P.effectID, rig.P.activeMode};
+                break;
+            }
+        }
+        frames++;
+    }
+    Serial.muted = false;
+
+    printf("  %u frames, %u events, %.0f frames/s (%.1f us/frame)\n", (unsigned)frames, (unsigned)events,
+           totalNs > 0.0 ? frames * 1e9 / totalNs : 0.0, frames ? totalNs / frames / 1000.0 : 0.0);
+    if (firstMismatch >= 0)
+        printf("  checksums: MISMATCH from frame %lld (of %u checked)\n", (long long)firstMismatch, (unsigned)hashes);
+    else
+        printf("  checksums: %u/%u match\n", (unsigned)hashes, (unsigned)hashes);
+    if (reader.isDamaged())
+        printf("  log damaged after frame %u, rest skipped\n", (unsigned)frames);
+
+    printf("  slowest:  frame   time (s)   render (us)  effect  mode\n");
+    for (const SlowFrame &s : slowest)
+    {
+        if (s.ns <= 0.0)
+            break;
+        printf("          %6u %10.2f %13.1f  %-7s %s\n", (unsigned)s.index, (s.nowUs - h.startUs) / 1e6,
+               s.ns / 1000.0, rig.show.effects().nameOf(s.effectID), RB_MODE_NAMES[(uint8_t)s.mode]);
+    }
+    return firstMismatch < 0 && !reader.isDamaged();
+}
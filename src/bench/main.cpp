@@ -0,0 +1,178 @@
+// Host-native render benchmark (env:native)
+//
+//   pio run -e native && .pio/build/native/program [frames] [file.wav]
+//   .pio/build/native/program replay <input log>
+//
+// Renders every lib/Lighting effect over a sweep of speed/intensity values
+// and detail LED counts and reports ns/frame and ns/LED, then the worst-case
+// crossfade frame and the particle pool at 10x load, runs the audio
+// analyzer over the WAV file (or a synthetic loop) for its cost per hop and
+// tempo, checks encoder counting through the PCNT mock, then checks the
+// fixed-point math kernels for accuracy and speed, and finally records a
+// scripted show and replays it through ShowController. Exits with 1 when
+// a fixed-point kernel is outside its documented error bound or the replay
+// doesn't reproduce the recording.
+//
+// `replay` only replays a log saved from the HUD's 'd' dump: checksums
+// against the device's frames, frames/s and the slowest frames. Exits with
+// 1 on a mismatch, a damaged log or one that can't be read.
+#include <Arduino.h>
+#include <FastLED.h>
+#include <chrono>
+#include <vector>
+
+#include "Bench.h"
+#include "LightingParams.h"
+#include "SpatialMap.h"
+#include "SpatialWaveEffect.h"
+#include "DoubleHelixEffect.h"
+#include "SphereEffect.h"
+#include "RainEffect.h"
+#include "EnergyBurstEffect.h"
+#include "EmergencyEffect.h"
+
+// Same geometry as src/main.cpp
+#define MAIN_LEDS_COUNT 2
+#define LED_STRING_SPACING_CM 3.0f
+#define DISC_LED_STRING_COUNT 8
+#define DISC_RADIUS_CM 5.0f
+
+static const uint16_t LED_COUNTS[] = {240, 480, 960};
+static const uint8_t SWEEP[] = {0, 128, 255};
+static const uint32_t WARMUP_FRAMES = 50;
+static const float FRAME_DT = 0.01f; // 100 FPS
+
+struct BenchResult
+{
+    double nsPerFrame;
+    double nsPerLed;
+};
+
+static BenchResult runEffect(Effect &fx, LightingParams &P, const SpatialMap &map,
+                             CRGB *mainLeds, CRGB *detailLeds, uint16_t nDetail,
+                             uint32_t frames)
+{
+    // Each sweep point is a fresh config; prepare() is not part of the frame time
+    fx.invalidate();
+    fx.prepareIfChanged(P);
+
+    uint32_t nowMs = 1;
+    for (uint32_t f = 0; f < WARMUP_FRAMES; f++, nowMs += 10)
+    {
+        P.beat.update(FRAME_DT);
+        fx.render(P, map, mainLeds, MAIN_LEDS_COUNT, detailLeds, nDetail, nowMs, FRAME_DT);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t f = 0; f < frames; f++, nowMs += 10)
+    {
+        P.beat.update(FRAME_DT);
+        fx.render(P, map, mainLeds, MAIN_LEDS_COUNT, detailLeds, nDetail, nowMs, FRAME_DT);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / frames;
+    return {ns, ns / nDetail};
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 2 && strcmp(argv[1], "replay") == 0)
+    {
+        if (!benchReplay(argv[2]))
+        {
+            printf("\nFAILED: replay did not reproduce the log\n");
+            return 1;
+        }
+        return 0;
+    }
+
+    uint32_t frames = 2000;
+    if (argc > 1)
+        frames = (uint32_t)atol(argv[1]);
+    if (frames == 0)
+        frames = 1;
+
+    printf("Effect render benchmark: %u frames per point, dt=%.0f ms\n\n",
+           (unsigned)frames, FRAME_DT * 1000.0f);
+    printf("%-12s %5s %5s %5s %12s %9s\n", "effect", "leds", "speed", "int", "ns/frame", "ns/LED");
+
+    for (uint16_t nDetail : LED_COUNTS)
+    {
+        SpatialMap map(nDetail, DISC_LED_STRING_COUNT, DISC_RADIUS_CM, LED_STRING_SPACING_CM, true);
+        map.begin();
+
+        std::vector<CRGB> detail(nDetail);
+        CRGB mainLeds[MAIN_LEDS_COUNT];
+
+        SpatialWaveEffect wave;
+        DoubleHelixEffect helix;
+        SphereEffect sphere;
+        RainEffect rain;
+        EnergyBurstEffect energy;
+        EmergencyEffect emergency;
+
+        struct
+        {
+            const char *name;
+            Effect *fx;
+            ConfigMode mode;
+        } effects[] = {
+            {"Wave", &wave, ConfigMode::Default},
+            {"Helix", &helix, ConfigMode::Default},
+            {"Sphere", &sphere, ConfigMode::Default},
+            {"Rain", &rain, ConfigMode::Default},
+            {"EnergyBurst", &energy, ConfigMode::Special2_EnergyBurst},
+            {"Emergency", &emergency, ConfigMode::Special3_Emergency},
+        };
+
+        for (auto &e : effects)
+        {
+            double sumFrame = 0.0, sumLed = 0.0;
+            uint8_t points = 0;
+
+            for (uint8_t speed : SWEEP)
+            {
+                for (uint8_t intensity : SWEEP)
+                {
+                    EffectConfig cfg;
+                    cfg.speed = speed;
+                    cfg.intensity = intensity;
+
+                    LightingParams P;
+                    P.activeConfig = &cfg;
+                    P.activeMode = e.mode;
+                    P.beat.setSpeed(speed);
+
+                    if (e.fx == &energy)
+                    {
+                        energy.reset();
+                        energy.setState(EnergyBurstState::BuildingUp, 0);
+                    }
+
+                    BenchResult r = runEffect(*e.fx, P, map, mainLeds, detail.data(), nDetail, frames);
+                    printf("%-12s %5u %5u %5u %12.0f %9.1f\n", e.name, nDetail, speed, intensity,
+                           r.nsPerFrame, r.nsPerLed);
+                    sumFrame += r.nsPerFrame;
+                    sumLed += r.nsPerLed;
+                    points++;
+                }
+            }
+
+            printf("%-12s %5u %11s %12.0f %9.1f\n\n", e.name, nDetail, "avg", sumFrame / points, sumLed / points);
+        }
+    }
+
+    benchCrossfade(frames);
+    benchParticles();
+    benchAudio(argc > 2 ? argv[2] : nullptr);
+    benchEncoder();
+    bool mathOk = benchFixedMath();
+    bool replayOk = benchReplay(nullptr);
+
+    if (!mathOk)
+        printf("\nFAILED: fixed-point error bound exceeded\n");
+    if (!replayOk)
+        printf("\nFAILED: replay did not reproduce the recorded show\n");
+    return mathOk && replayOk ? 0 : 1;
+}
@@ -7,17 +7,14 @@
 #include "ConfigManager.h"
 
 #include "InputManager.h"
-#include "InputMapper.h"
 #include "Pot.h"
 #include "LedEngine.h"
 #include "SerialHUD.h"
-
-#include "SpatialWaveEffect.h"
-#include "DoubleHelixEffect.h"
-#include "EnergyBurstEffect.h"
-#include "EmergencyEffect.h"
-#include "SphereEffect.h"
-#include "RainEffect.h"
+#include "FrameScheduler.h"
+#include "FrameProfiler.h"
+#include "AudioInput.h"
+#include "ShowController.h"
+#include "InputLog.h"
 
 // ============ LED Setup ============
 
@@ -27,31 +24,22 @@
 #define DISC_LED_STRING_COUNT 8
 #define DISC_RADIUS_CM 5.0f
 
+// ============ Input Log ============
+// RAM kept for recording the show's inputs from boot (dump with 'd');
+// at 100 FPS a quiet frame takes one byte. 0 = no recording.
+#define INPUT_LOG_BYTES 32768
+
+// ============ Frame Rate ============
+// 240 WS2812B pixels take ~7.2ms on the wire, so 100 FPS leaves headroom
+#define TARGET_FPS 100
+
 // ============ Effect BPM Range ============
 #define MIN_BPM 50.0f
 #define MAX_BPM 180.0f
 
-// ============ Helper Functions ============
-
-// Linearize brightness for FastLED
-// FastLED uses gamma ≈ 2.2 internally, so we need to apply the inverse (raise to power 2.2)
-// to get linear perceived brightness across the full 0-255 range
-inline uint8_t linearizeBrightness(uint8_t input)
-{
-    // Normalize input to 0.0-1.0
-    float normalized = input / 255.0f;
-
-    // Apply gamma correction: output = input^2.2
-    float corrected = pow(normalized, 2.2f);
-
-    // Scale back to 0-255
-    return (uint8_t)(corrected * 255.0f + 0.5f);
-}
-
-CRGB mainLeds[MAIN_LEDS_COUNT];
-CRGB detailLeds[DETAIL_LEDS_COUNT];
-
-LedEngine ledEngine(mainLeds, MAIN_LEDS_COUNT, detailLeds, DETAIL_LEDS_COUNT);
+// LedEngine owns the double-buffered frames; render into ledEngine.mainLeds/detailLeds
+LedEngine ledEngine(MAIN_LEDS_COUNT, DETAIL_LEDS_COUNT);
+FastLEDTransport ledTransport;
 
 SerialHUD hud;
 
@@ -65,6 +53,10 @@ SpatialMap spatial(DETAIL_LEDS_COUNT, DISC_LED_STRING_COUNT, DISC_RADIUS_CM, LED
 // ============ Encoders ============
 static const uint8_t DET = 4, DB = 10;
 
+// Quadrature steps are counted by the PCNT peripheral: no per-step
+// interrupts competing with LED transmission, hardware glitch filtering
+static const EncoderBackend ENC_BACKEND = EncoderBackend::Pcnt;
+
 // Encoder rotation sensitivity settings
 // Parameter = number of full rotations needed to go from 0 to 255
 // Lower values = more sensitive (less rotation needed)
@@ -84,11 +76,11 @@ static const uint8_t DET = 4, DB = 10;
 // enc4: Intensity       - 1.0 rotations
 // enc5: Effect/Speed    - 1.0 rotations
 
-Encoder enc1(21, 22, 32, true, DET, DB, 2.0f); // Main Hue
-Encoder enc2(16, 17, 33, true, DET, DB, 2.0f); // Main Sat
-Encoder enc3(13, 14, 4, true, DET, DB, -1.0f); // Secondary Hue
-Encoder enc4(18, 19, 5, true, DET, DB, 1.0f);  // Intensity
-Encoder enc5(23, 25, 15, true, DET, DB, 1.0f); // Effect/Speed
+Encoder enc1(21, 22, 32, true, DET, DB, 2.0f, ENC_BACKEND); // Main Hue
+Encoder enc2(16, 17, 33, true, DET, DB, 2.0f, ENC_BACKEND); // Main Sat
+Encoder enc3(13, 14, 4, true, DET, DB, -1.0f, ENC_BACKEND); // Secondary Hue
+Encoder enc4(18, 19, 5, true, DET, DB, 1.0f, ENC_BACKEND);  // Intensity
+Encoder enc5(23, 25, 15, true, DET, DB, 1.0f, ENC_BACKEND); // Effect/Speed
 
 Encoder *encs[] = {&enc1, &enc2, &enc3, &enc4, &enc5};
 
@@ -98,23 +90,32 @@ Pot pot(POT_PIN);
 
 // ============ Input system ============
 InputManager input(encs, 5, &pot);
-InputMapper mapper;
+
+// ============ Audio ============
+// I2S mic/line ADC, analysed on a background task; results land in P.audio
+I2SAudioSource audioSource;
+AudioInput audioIn;
 
 // ============ Config System ============
 ConfigManager configMgr;
 
-// ============ Effects ============
-EffectManager fx;
-SpatialWaveEffect waveFx;
-DoubleHelixEffect helixFx;
-EnergyBurstEffect energyBurstFx;
-EmergencyEffect emergencyFx;
-SphereEffect sphereFx;
-RainEffect rainFx;
-
 // Lighting state
 LightingParams P;
 
+// ============ Show ============
+// Modes, effects and layers; renders the frame from P and the inputs
+ShowController show(P, configMgr);
+
+// Records what the show is fed, for replay on the host
+InputLogWriter inputLog;
+uint32_t showSeed;
+
+// Frame clock
+FrameScheduler scheduler(TARGET_FPS);
+
+// Frame profiler (dump with 'p' on the serial console)
+FrameProfiler profiler;
+
 // ============ Boot Animation ============
 #define BOOT_SEQUENCE_LENGTH 500
 uint32_t bootStart;
@@ -130,11 +131,11 @@ void bootAnimation(uint32_t now)
         ledEngine.clearAll();
 
         // Apply current brightness slider value before switching to normal power limit
-        FastLED.setBrightness(linearizeBrightness(P.brightness));
-        FastLED.show();
+        ledEngine.setBrightness(P.brightness);
+        ledEngine.present();
 
         // Switch to normal operating power limit
-        ledEngine.setPowerLimit(5, MAX_MA);
+        ledEngine.setPowerLimit(MAX_MA);
         Serial.printf("Boot complete - switched to %dmA power limit with brightness=%d\n", MAX_MA, P.brightness);
 
         return;
@@ -153,49 +154,36 @@ void bootAnimation(uint32_t now)
     if (showMain)
     {
         // Main color phase: main LEDs lit, detail LEDs off
-        fill_solid(mainLeds, MAIN_LEDS_COUNT, mainColor);
-        fill_solid(detailLeds, DETAIL_LEDS_COUNT, CRGB::Black);
+        fill_solid(ledEngine.mainLeds, MAIN_LEDS_COUNT, mainColor);
+        fill_solid(ledEngine.detailLeds, DETAIL_LEDS_COUNT, CRGB::Black);
     }
     else
     {
         // Secondary color phase: detail LEDs lit, main LEDs off
-        fill_solid(mainLeds, MAIN_LEDS_COUNT, CRGB::Black);
-        fill_solid(detailLeds, DETAIL_LEDS_COUNT, secondaryColor);
+        fill_solid(ledEngine.mainLeds, MAIN_LEDS_COUNT, CRGB::Black);
+        fill_solid(ledEngine.detailLeds, DETAIL_LEDS_COUNT, secondaryColor);
     }
 
-    FastLED.show();
+    ledEngine.present();
 }
 
-// ============ Strobe Overlay ============
-static inline uint16_t strobePeriodMs(uint8_t s)
+// ============ Input Log ============
+// Starts recording with the state the show has right now
+void startInputLog(uint64_t prevFrameUs)
 {
-    // 255 -> ~30ms, 0 -> ~1000ms
-    return (uint16_t)(1000 - (s * 970) / 255) + 30;
-}
-
-void applyStrobe(uint32_t now)
-{
-    if (!P.strobeActive)
-        return;
-
-    // Get strobe color from Special1 config
-    EffectConfig &strobeConfig = configMgr.getConfig(ConfigMode::Special1_Strobe);
-    uint16_t period = strobePeriodMs(strobeConfig.speed);
-    const bool on = (now % period) < (period / 2);
-
-    if (on)
-    {
-        // Adjustable color strobe
-        CRGB strobeColor = CHSV(strobeConfig.mainHue, strobeConfig.mainSat, 255);
-        fill_solid(mainLeds, MAIN_LEDS_COUNT, strobeColor);
-        fill_solid(detailLeds, DETAIL_LEDS_COUNT, CRGB::Black);
-    }
-    else
-    {
-        // Off phase
-        fill_solid(mainLeds, MAIN_LEDS_COUNT, CRGB::Black);
-        fill_solid(detailLeds, DETAIL_LEDS_COUNT, CRGB::Black);
-    }
+    InputLogHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "TLOG", 4);
+    h.version = INPUT_LOG_VERSION;
+    h.mainCount = MAIN_LEDS_COUNT;
+    h.detailCount = DETAIL_LEDS_COUNT;
+    h.periodUs = scheduler.budgetUs();
+    h.seed = showSeed;
+    h.startUs = prevFrameUs;
+    h.minBpm = MIN_BPM;
+    h.maxBpm = MAX_BPM;
+    configMgr.exportSnapshot(h.config);
+    inputLog.begin(h, INPUT_LOG_BYTES);
 }
 
 // ============ Save Feedback ============
@@ -204,14 +192,14 @@ void showSaveFeedback()
     // 0.5s green strobe on all LEDs
     for (int i = 0; i < 5; i++)
     {
-        fill_solid(mainLeds, MAIN_LEDS_COUNT, CRGB::Green);
-        fill_solid(detailLeds, DETAIL_LEDS_COUNT, CRGB::Green);
-        FastLED.show();
+        fill_solid(ledEngine.mainLeds, MAIN_LEDS_COUNT, CRGB::Green);
+        fill_solid(ledEngine.detailLeds, DETAIL_LEDS_COUNT, CRGB::Green);
+        ledEngine.present();
         delay(50);
 
-        fill_solid(mainLeds, MAIN_LEDS_COUNT, CRGB::Black);
-        fill_solid(detailLeds, DETAIL_LEDS_COUNT, CRGB::Black);
-        FastLED.show();
+        fill_solid(ledEngine.mainLeds, MAIN_LEDS_COUNT, CRGB::Black);
+        fill_solid(ledEngine.detailLeds, DETAIL_LEDS_COUNT, CRGB::Black);
+        ledEngine.present();
         delay(50);
     }
     Serial.println("✅ Configs saved!");
@@ -225,243 +213,99 @@ void setup()
     Serial.println("\n=== Festival Totem Firmware ===");
 
     input.begin();
-    pot.begin();
 
-    ledEngine.begin();
+    ledEngine.begin(&ledTransport);
     // Use safe boot power limit (400mA for laptop USB)
-    ledEngine.setPowerLimit(5, BOOT_MAX_MA);
+    ledEngine.setPowerLimit(BOOT_MAX_MA);
     Serial.printf("Boot mode - using %dmA power limit\n", BOOT_MAX_MA);
 
     // Clear all LEDs immediately
-    fill_solid(mainLeds, MAIN_LEDS_COUNT, CRGB::Black);
-    fill_solid(detailLeds, DETAIL_LEDS_COUNT, CRGB::Black);
-    FastLED.show();
+    ledEngine.clearAll();
+    ledEngine.present();
 
     spatial.begin();
 
     // Initialize config system
     configMgr.begin();
 
-    // Configure EnergyBurst effect secondary brightness range
-    // secondaryBrightnessMin (26 ≈ 10% brightness) - brightness at intensity=0
-    // secondaryBrightnessMax (51 ≈ 20% brightness) - brightness at intensity=255
-    // Values scale linearly with intensity parameter
-    energyBurstFx.setSecondaryBrightnessRange(26, 51);
-
-    // Configure EnergyBurst explosion height threshold
-    // 0.0 = bottom of LEDs, 1.0 = top of LEDs
-    // At 0.2, explosion only cancels if intensity is very low (spinning point below 20% height)
-    energyBurstFx.setExplosionHeightThreshold(0.2f); // Point P to default config initially
-    P.activeConfig = &configMgr.getConfig(ConfigMode::Default);
-    P.activeMode = ConfigMode::Default;
-    P.effectID = configMgr.getBootEffectID();
-
-    // Register effects
-    fx.add(&waveFx, "Wave");
-    fx.add(&helixFx, "Helix");
-    fx.add(&sphereFx, "Sphere");
-    fx.add(&rainFx, "Rain");
+    // Modes, effects and layers; P starts on the Default config
+    profiler.begin();
+    ledEngine.setProfiler(&profiler);
+    show.begin(MAIN_LEDS_COUNT, DETAIL_LEDS_COUNT, &profiler);
+    P.beat.setRange(MIN_BPM, MAX_BPM);
+
+    // Every boot rains differently; the seed goes into the input log
+    showSeed = esp_random();
+    show.seed(showSeed);
+
+    if (audioIn.begin(&audioSource))
+        Serial.printf("Audio input on I2S at %u Hz\n", (unsigned)AUDIO_SAMPLE_RATE);
+    else
+        Serial.println("Audio input unavailable - tempo stays on the Speed encoder");
 
     hud.begin();
 
     bootStart = millis();
+    scheduler.begin();
 
     Serial.println("Startup complete!");
 }
 
 void loop()
 {
-    uint32_t now = millis();
+    // Wait for the next frame slot
+    const FrameTime &ft = scheduler.waitForFrame();
+    uint32_t now = ft.nowMs;
+    static uint64_t prevFrameUs = 0;
 
     // Boot
     if (bootActive)
     {
         bootAnimation(now);
+        prevFrameUs = ft.nowUs;
+        scheduler.endFrame();
         return;
     }
 
-    // Read input and handle mode switching
-    InputEvent ev;
-    if (input.poll(ev))
+    // The recording starts with the first show frame
+    if (INPUT_LOG_BYTES && prevFrameUs)
     {
-        // Handle mode switching events
-        switch (ev.action)
-        {
-        case InputAction::EnterSpecial1: // Enc5 pressed
-            // Cancel EnergyBurst if active
-            if (P.energyBurstState != EnergyBurstState::Inactive)
-            {
-                P.energyBurstState = EnergyBurstState::Inactive;
-                energyBurstFx.reset();
-                // Reset intensity to zero
-                configMgr.getConfig(ConfigMode::Special2_EnergyBurst).intensity = 0;
-            }
-            configMgr.setMode(ConfigMode::Special1_Strobe);
-            P.activeConfig = &configMgr.getActiveConfig();
-            P.activeMode = ConfigMode::Special1_Strobe;
-            P.strobeActive = true;
-            Serial.println("→ Special1: Strobe ON");
-            hud.markDirty();
-            break;
-
-        case InputAction::ExitSpecial1: // Enc5 released
-            configMgr.setMode(ConfigMode::Default);
-            P.activeConfig = &configMgr.getActiveConfig();
-            P.activeMode = ConfigMode::Default;
-            P.strobeActive = false;
-            Serial.println("→ Default mode");
-            hud.markDirty();
-            break;
-
-        case InputAction::EnterSpecial2: // Enc4 pressed
-        {
-            EnergyBurstState currentState = P.energyBurstState;
-
-            if (currentState == EnergyBurstState::Inactive)
-            {
-                // Start energy buildup
-                configMgr.setMode(ConfigMode::Special2_EnergyBurst);
-                P.activeConfig = &configMgr.getActiveConfig();
-                P.activeMode = ConfigMode::Special2_EnergyBurst;
-                P.energyBurstState = EnergyBurstState::BuildingUp;
-                energyBurstFx.setState(EnergyBurstState::BuildingUp);
-                Serial.println("→ Special2: Energy BuildUp");
-                hud.markDirty();
-            }
-            else if (currentState == EnergyBurstState::BuildingUp)
-            {
-                // Check height threshold (intensity maps to height ratio: 0-255 → 0.0-1.0)
-                float heightRatio = P.activeConfig->intensity / 255.0f;
-                float threshold = energyBurstFx.getExplosionHeightThreshold();
-
-                if (heightRatio >= threshold)
-                {
-                    // Trigger explosion
-                    P.energyBurstState = EnergyBurstState::Exploding;
-                    energyBurstFx.setState(EnergyBurstState::Exploding);
-                    P.explosionStartTime = now;
-                    Serial.println("→ Special2: EXPLOSION!");
-                    hud.markDirty();
-                }
-                else
-                {
-                    // Cancel effect - height too low
-                    configMgr.setMode(ConfigMode::Default);
-                    P.activeConfig = &configMgr.getActiveConfig();
-                    P.activeMode = ConfigMode::Default;
-                    P.energyBurstState = EnergyBurstState::Inactive;
-                    energyBurstFx.reset();
-                    // Reset intensity to zero
-                    configMgr.getConfig(ConfigMode::Special2_EnergyBurst).intensity = 0;
-                    Serial.println("→ Default mode (Energy cancelled - height below threshold)");
-                    hud.markDirty();
-                }
-            }
-            break;
-        }
-
-        case InputAction::EnterSpecial3: // Enc3 pressed
-            // Cancel EnergyBurst if active
-            if (P.energyBurstState != EnergyBurstState::Inactive)
-            {
-                P.energyBurstState = EnergyBurstState::Inactive;
-                energyBurstFx.reset();
-                // Reset intensity to zero
-                configMgr.getConfig(ConfigMode::Special2_EnergyBurst).intensity = 0;
-            }
-            configMgr.setMode(ConfigMode::Special3_Emergency);
-            P.activeConfig = &configMgr.getActiveConfig();
-            P.activeMode = ConfigMode::Special3_Emergency;
-            P.emergencyActive = true;
-            Serial.println("→ Special3: Emergency Lights ON");
-            hud.markDirty();
-            break;
-
-        case InputAction::ExitSpecial3: // Enc3 released
-            configMgr.setMode(ConfigMode::Default);
-            P.activeConfig = &configMgr.getActiveConfig();
-            P.activeMode = ConfigMode::Default;
-            P.emergencyActive = false;
-            Serial.println("→ Default mode");
-            hud.markDirty();
-            break;
-
-        case InputAction::SaveConfigs: // Enc4 + Enc5 held 5s
-            configMgr.setBootEffectID(P.effectID);
-            configMgr.save();
-            showSaveFeedback();
-            break;
-
-        default:
-            // Let mapper handle all other actions
-            if (mapper.apply(ev, P))
-            {
-                // Wrap effect ID (handle both positive and negative wrapping)
-                // Convert to signed to handle negative deltas correctly
-                int16_t effectCount = (int16_t)fx.count();
-                int16_t signedEffectID = (int16_t)P.effectID;
-
-                // Wrap around: ensure result is always in range [0, effectCount)
-                signedEffectID = ((signedEffectID % effectCount) + effectCount) % effectCount;
-                P.effectID = (uint8_t)signedEffectID;
-
-                if (fx.setEffect(P.effectID))
-                {
-                    hud.markDirty();
-                }
-                // Mark dirty for any parameter changes
-                hud.markDirty();
-            }
-            break;
-        }
+        startInputLog(prevFrameUs);
+        prevFrameUs = 0;
     }
 
-    // Check if explosion finished (auto-exit after 2s)
-    if (P.energyBurstState == EnergyBurstState::Exploding)
+    // Drain every input event since the last frame, in order
+    InputEvent events[INPUT_QUEUE_SIZE];
+    uint8_t eventCount;
     {
-        if (now - P.explosionStartTime >= 2000)
-        {
-            configMgr.setMode(ConfigMode::Default);
-            P.activeConfig = &configMgr.getActiveConfig();
-            P.activeMode = ConfigMode::Default;
-            P.energyBurstState = EnergyBurstState::Inactive;
-            energyBurstFx.reset();
-            // Reset intensity to zero
-            configMgr.getConfig(ConfigMode::Special2_EnergyBurst).intensity = 0;
-            Serial.println("→ Default mode (Explosion complete)");
-            hud.markDirty();
-        }
+        ProfileScope scope(&profiler, ProfileStage::Input);
+        eventCount = input.drain(events, INPUT_QUEUE_SIZE);
+        audioIn.latest(P.audio);
     }
-
-    // Apply linearized brightness to compensate for FastLED's non-linear dimming
-    FastLED.setBrightness(linearizeBrightness(P.brightness));
-
-    // Render based on active mode
-    if (P.activeMode == ConfigMode::Special2_EnergyBurst &&
-        P.energyBurstState != EnergyBurstState::Inactive)
-    {
-        // Render energy burst effect
-        energyBurstFx.render(P, spatial, mainLeds, MAIN_LEDS_COUNT, detailLeds, DETAIL_LEDS_COUNT, now);
-    }
-    else if (P.activeMode == ConfigMode::Special3_Emergency && P.emergencyActive)
-    {
-        // Render emergency effect
-        emergencyFx.render(P, spatial, mainLeds, MAIN_LEDS_COUNT, detailLeds, DETAIL_LEDS_COUNT, now);
-    }
-    else if (P.activeMode == ConfigMode::Default)
+    for (uint8_t i = 0; i < eventCount; i++)
     {
-        // Render normal effects
-        fx.setEffect(P.effectID);
-        fx.render(P, spatial, mainLeds, MAIN_LEDS_COUNT, detailLeds, DETAIL_LEDS_COUNT, now);
+        show.handleInput(events[i], now);
+        if (events[i].action == InputAction::SaveConfigs)
+            showSaveFeedback();
     }
+    show.update(ft);
 
-    hud.update(P, fx, now);
+    // LedEngine gamma-maps the slider to 16-bit and dithers the low end
+    ledEngine.setBrightness(P.brightness);
 
-    // Apply strobe overlay (Special1) if active
-    if (P.strobeActive)
-    {
-        applyStrobe(now);
-    }
+    show.render(spatial, ledEngine.mainLeds, MAIN_LEDS_COUNT, ledEngine.detailLeds, DETAIL_LEDS_COUNT, ft);
+
+    if (show.takeDirty())
+        hud.markDirty();
+
+    inputLog.frame(ft, events, eventCount, P.audio,
+                   ledEngine.mainLeds, MAIN_LEDS_COUNT, ledEngine.detailLeds, DETAIL_LEDS_COUNT);
+    hud.update(P, show.effects(), now);
+    hud.handleCommands(profiler, scheduler, ledEngine, audioIn, input, inputLog);
 
-    FastLED.show();
+    // Hand off to the show task; the next frame renders while this one is sent.
+    // Unchanged frames (strobe off-phase, static effects) are skipped.
+    ledEngine.present();
+    scheduler.endFrame();
+    profiler.endFrame();
 }